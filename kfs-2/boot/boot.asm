@@ -5,31 +5,63 @@ FLAGS       equ MBALIGN | MEMINFO
 MAGIC       equ 0x1BADB002
 CHECKSUM    equ -(MAGIC + FLAGS)
 
+; Stack constants (must match kernel/include/stack.h)
+KERNEL_STACK_SIZE equ 16384
+IRQ_STACK_SIZE    equ 4096
+DF_STACK_SIZE     equ 4096
+STACK_GUARD_SIZE  equ 4096
+STACK_PAINT       equ 0xDEADBEEF
+
 section .multiboot
 align 4
     dd MAGIC
     dd FLAGS
     dd CHECKSUM
 
-section .bss
-align 16
+; Each stack sits on top of its own guard page, which init_paging leaves
+; unmapped: an overflow faults there instead of running into .bss.
+section .bss align=4096
+global stack_bottom
+global stack_top
+global irq_stack
+global df_stack
+alignb 4096
+    resb STACK_GUARD_SIZE
 stack_bottom:
-    resb 16384 ; 16 KiB
+    resb KERNEL_STACK_SIZE ; 16 KiB
 stack_top:
+    resb STACK_GUARD_SIZE
+irq_stack:
+    resb IRQ_STACK_SIZE
+    resb STACK_GUARD_SIZE
+df_stack:
+    resb DF_STACK_SIZE
 
 section .text
 global _start
 extern kernel_main
 
 _start:
+    ; Keep the multiboot magic (EAX) across the paint loop; EBX is untouched
+    mov edx, eax
+
+    ; Paint the stack so its high-water mark can be measured later
+    cld
+    mov edi, stack_bottom
+    mov ecx, KERNEL_STACK_SIZE / 4
+    mov eax, STACK_PAINT
+    rep stosd
+
     ; Setup stack
     mov esp, stack_top
 
-    ; Call kernel
+    ; Call kernel: kernel_main(magic, multiboot_info)
+    push ebx
+    push edx
     call kernel_main
 
     ; If kernel returns, halt the CPU
     cli
 .hang:
     hlt
-    jmp .hang
\ No newline at end of file
+    jmp .hang
@@ -0,0 +1,31 @@
+#ifndef CPU_H
+#define CPU_H
+
+#include "types.h"
+
+/* Read the time stamp counter (cycles since reset) */
+static inline uint64_t rdtsc(void) {
+    uint32_t lo, hi;
+    asm volatile ("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+/* Spin-wait hint: saves power and avoids a memory-order flush on exit */
+static inline void cpu_pause(void) {
+    asm volatile ("pause" ::: "memory");
+}
+
+/* Disable interrupts, returning the previous EFLAGS for irq_restore() */
+static inline uint32_t irq_save(void) {
+    uint32_t flags;
+    asm volatile ("pushf; pop %0; cli" : "=r"(flags) : : "memory");
+    return flags;
+}
+
+/* Re-enable interrupts only if they were enabled before irq_save() */
+static inline void irq_restore(uint32_t flags) {
+    if (flags & 0x200)
+        asm volatile ("sti" ::: "memory");
+}
+
+#endif /* CPU_H */
@@ -0,0 +1,68 @@
+#ifndef ELF_H
+#define ELF_H
+
+#include "types.h"
+
+#define EI_NIDENT   16
+#define ELFCLASS32  1
+#define ELFDATA2LSB 1
+#define ET_EXEC     2
+#define EM_386      3
+
+#define PT_LOAD 1
+
+/* Segment permission flags */
+#define PF_X 0x1
+#define PF_W 0x2
+#define PF_R 0x4
+
+#define ELF_MAX_SEGMENTS 8
+
+/* ELF32 file header */
+struct elf32_ehdr {
+    uint8_t e_ident[EI_NIDENT];
+    uint16_t e_type;
+    uint16_t e_machine;
+    uint32_t e_version;
+    uint32_t e_entry;
+    uint32_t e_phoff;
+    uint32_t e_shoff;
+    uint32_t e_flags;
+    uint16_t e_ehsize;
+    uint16_t e_phentsize;
+    uint16_t e_phnum;
+    uint16_t e_shentsize;
+    uint16_t e_shnum;
+    uint16_t e_shstrndx;
+} __attribute__((packed));
+
+/* ELF32 program header */
+struct elf32_phdr {
+    uint32_t p_type;
+    uint32_t p_offset;
+    uint32_t p_vaddr;
+    uint32_t p_paddr;
+    uint32_t p_filesz;
+    uint32_t p_memsz;
+    uint32_t p_flags;
+    uint32_t p_align;
+} __attribute__((packed));
+
+/* What elf_load() mapped, for unloading and footprint reporting */
+struct elf_load_info {
+    uint32_t entry;
+    uint32_t shared;        // Bytes mapped straight from the image
+    uint32_t copied;        // Bytes copied into private frames at load
+    uint32_t reserved;      // Bytes of address space reserved
+    int region_count;
+    uint32_t regions[ELF_MAX_SEGMENTS];
+};
+
+/* Map the PT_LOAD segments of an in-memory ELF32 image into user space.
+   Returns 0 on success, -1 (after printing why) on failure */
+int elf_load(const uint8_t *image, size_t size, struct elf_load_info *info);
+
+/* Release everything elf_load() mapped */
+void elf_unload(struct elf_load_info *info);
+
+#endif /* ELF_H */
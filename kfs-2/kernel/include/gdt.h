@@ -3,6 +3,19 @@
 
 #include "types.h"
 
+/* Number of descriptors in the GDT */
+#define GDT_ENTRIES 9
+
+/* Segment selectors (index * 8, RPL in the low two bits) */
+#define GDT_KERNEL_CODE_SEL  0x08
+#define GDT_KERNEL_DATA_SEL  0x10
+#define GDT_KERNEL_STACK_SEL 0x18
+#define GDT_USER_CODE_SEL    0x20
+#define GDT_USER_DATA_SEL    0x28
+#define GDT_USER_STACK_SEL   0x30
+#define GDT_TSS_SEL          0x38
+#define GDT_DF_TSS_SEL       0x40
+
 /* A GDT entry is 8 bytes */
 struct gdt_entry {
     uint16_t limit_low;     // Lower 16 bits of limit
@@ -19,11 +32,49 @@ struct gdt_ptr {
     uint32_t base;          // Base address of the first gdt_entry
 } __attribute__((packed));
 
+/* 32-bit Task State Segment, as laid out by the CPU */
+struct tss_entry {
+    uint32_t prev_tss;      // Back link to the previous task
+    uint32_t esp0;          // Stack loaded on a switch to ring 0
+    uint32_t ss0;
+    uint32_t esp1;
+    uint32_t ss1;
+    uint32_t esp2;
+    uint32_t ss2;
+    uint32_t cr3;
+    uint32_t eip;
+    uint32_t eflags;
+    uint32_t eax;
+    uint32_t ecx;
+    uint32_t edx;
+    uint32_t ebx;
+    uint32_t esp;
+    uint32_t ebp;
+    uint32_t esi;
+    uint32_t edi;
+    uint32_t es;
+    uint32_t cs;
+    uint32_t ss;
+    uint32_t ds;
+    uint32_t fs;
+    uint32_t gs;
+    uint32_t ldt;
+    uint16_t trap;
+    uint16_t iomap_base;    // Offset of the I/O bitmap (none: sizeof TSS)
+} __attribute__((packed));
+
 /* We place our GDT in its own section so the linker puts it at 0x800 */
 extern struct gdt_entry gdt_entries[];
 extern struct gdt_ptr gdt_ptr;
 
+/* Kernel task (loaded with LTR) and the task the double fault gate runs */
+extern struct tss_entry kernel_tss;
+extern struct tss_entry df_tss;
+
 /* Initialize and load the GDT */
 void init_gdt(void);
 
+/* Reload GDTR with the same table seen at another linear address */
+void gdt_relocate(uint32_t base);
+
 #endif /* GDT_H */
@@ -0,0 +1,54 @@
+#ifndef IDT_H
+#define IDT_H
+
+#include "types.h"
+
+#define IDT_ENTRIES 256
+
+/* Hardware IRQs are remapped past the CPU exception vectors */
+#define IRQ_BASE 32
+#define IRQ0     (IRQ_BASE + 0)
+#define IRQ1     (IRQ_BASE + 1)
+
+/* Software interrupt used by user programs for system calls */
+#define SYSCALL_VECTOR 0x80
+
+/* An IDT gate is 8 bytes */
+struct idt_entry {
+    uint16_t base_low;      // Lower 16 bits of handler address
+    uint16_t sel;           // Code segment selector (or TSS for task gates)
+    uint8_t always0;
+    uint8_t flags;          // Present, DPL and gate type
+    uint16_t base_high;     // Upper 16 bits of handler address
+} __attribute__((packed));
+
+/* Pointer structure to pass to LIDT */
+struct idt_ptr {
+    uint16_t limit;
+    uint32_t base;
+} __attribute__((packed));
+
+/* Register state pushed by the entry stubs in interrupt.asm */
+struct regs {
+    uint32_t gs, fs, es, ds;
+    uint32_t edi, esi, ebp, esp, ebx, edx, ecx, eax;
+    uint32_t int_no, err_code;
+    uint32_t eip, cs, eflags, useresp, ss;   // Pushed by the CPU
+};
+
+typedef void (*isr_t)(struct regs *r);
+
+/* Build and load the IDT, remap the PIC and mask every IRQ */
+void init_idt(void);
+
+/* Install a C handler for an exception, IRQ or software interrupt */
+void register_interrupt_handler(uint8_t n, isr_t handler);
+
+/* Allow an IRQ line (0-15) through the PIC */
+void irq_unmask(uint8_t irq);
+
+/* Called from interrupt.asm */
+void isr_handler(struct regs *r);
+void irq_handler(struct regs *r);
+
+#endif /* IDT_H */
@@ -0,0 +1,222 @@
+#ifndef LOCK_H
+#define LOCK_H
+
+#include "types.h"
+#include "cpu.h"
+
+/*
+ * Spinlocks, ticket locks and reader-writer locks.
+ *
+ * Every lock is padded to its own cache line so two hot locks never
+ * bounce the same line between CPUs. Waiters spin on a plain read with
+ * `pause` and only retry the locked instruction once the lock looks free.
+ *
+ * Build with LOCK_DEBUG (make LOCK_DEBUG=1) to count acquisitions,
+ * contended acquisitions, spin iterations and the longest hold time of
+ * every lock; `lockstat` in the shell prints them.
+ */
+
+#define CACHE_LINE_SIZE 64
+
+#ifdef LOCK_DEBUG
+struct lock_stats {
+    const char *name;
+    uint32_t acquisitions;
+    uint32_t contended;         // Acquisitions that had to spin
+    uint32_t spins;             // Total spin iterations
+    uint32_t max_hold;          // Longest exclusive hold, in cycles
+    uint64_t acquired_at;       // rdtsc() of the current exclusive holder
+    volatile uint32_t registered;
+    struct lock_stats *next;
+};
+#define LOCK_STATS_INIT(n) .stats = { .name = (n) },
+
+void lock_stats_acquired(struct lock_stats *s, uint32_t spins, int exclusive);
+void lock_stats_released(struct lock_stats *s);
+#else
+#define LOCK_STATS_INIT(n)
+#endif
+
+/* Test-and-test-and-set lock */
+struct spinlock {
+    volatile uint32_t locked;
+#ifdef LOCK_DEBUG
+    struct lock_stats stats;
+#endif
+} __attribute__((aligned(CACHE_LINE_SIZE)));
+
+/* FIFO lock: waiters are served in the order they took a ticket */
+struct ticketlock {
+    union {
+        volatile uint32_t word;
+        struct {
+            volatile uint16_t owner;    // Ticket being served
+            volatile uint16_t next;     // Next ticket to hand out
+        } t;
+    };
+#ifdef LOCK_DEBUG
+    struct lock_stats stats;
+#endif
+} __attribute__((aligned(CACHE_LINE_SIZE)));
+
+/* Many readers or one writer; a waiting writer blocks new readers */
+#define RW_WRITER  0x80000000
+#define RW_READERS 0x7FFFFFFF
+
+struct rwlock {
+    volatile uint32_t count;            // RW_WRITER bit + number of readers
+#ifdef LOCK_DEBUG
+    struct lock_stats stats;
+#endif
+} __attribute__((aligned(CACHE_LINE_SIZE)));
+
+#define SPINLOCK_INIT(n)   { .locked = 0, LOCK_STATS_INIT(n) }
+#define TICKETLOCK_INIT(n) { .word = 0, LOCK_STATS_INIT(n) }
+#define RWLOCK_INIT(n)     { .count = 0, LOCK_STATS_INIT(n) }
+
+#ifdef LOCK_DEBUG
+#define LOCK_ACQUIRED(l, spins, ex) lock_stats_acquired(&(l)->stats, (spins), (ex))
+#define LOCK_RELEASED(l)            lock_stats_released(&(l)->stats)
+#else
+#define LOCK_ACQUIRED(l, spins, ex) ((void)(spins))
+#define LOCK_RELEASED(l)            ((void)0)
+#endif
+
+static inline uint32_t atomic_xchg(volatile uint32_t *p, uint32_t v) {
+    asm volatile ("xchgl %0, %1" : "+r"(v), "+m"(*p) : : "memory");
+    return v;
+}
+
+static inline uint32_t atomic_fetch_add(volatile uint32_t *p, uint32_t v) {
+    asm volatile ("lock xaddl %0, %1" : "+r"(v), "+m"(*p) : : "memory");
+    return v;
+}
+
+/* Returns 1 if *p was old and is now new */
+static inline int atomic_cmpxchg(volatile uint32_t *p, uint32_t old, uint32_t new) {
+    uint32_t prev;
+    asm volatile ("lock cmpxchgl %2, %1"
+                  : "=a"(prev), "+m"(*p) : "r"(new), "0"(old) : "memory");
+    return prev == old;
+}
+
+/* --- Spinlock --- */
+
+static inline void spin_lock(struct spinlock *l) {
+    uint32_t spins = 0;
+
+    while (atomic_xchg(&l->locked, 1)) {
+        while (l->locked) {
+            cpu_pause();
+            spins++;
+        }
+    }
+    LOCK_ACQUIRED(l, spins, 1);
+}
+
+static inline int spin_trylock(struct spinlock *l) {
+    if (atomic_xchg(&l->locked, 1))
+        return 0;
+    LOCK_ACQUIRED(l, 0, 1);
+    return 1;
+}
+
+static inline void spin_unlock(struct spinlock *l) {
+    LOCK_RELEASED(l);
+    asm volatile ("" ::: "memory");
+    l->locked = 0;
+}
+
+/* For data also touched by interrupt handlers */
+static inline uint32_t spin_lock_irqsave(struct spinlock *l) {
+    uint32_t flags = irq_save();
+    spin_lock(l);
+    return flags;
+}
+
+static inline void spin_unlock_irqrestore(struct spinlock *l, uint32_t flags) {
+    spin_unlock(l);
+    irq_restore(flags);
+}
+
+/* --- Ticket lock --- */
+
+static inline void ticket_lock(struct ticketlock *l) {
+    uint16_t ticket = atomic_fetch_add(&l->word, 0x10000) >> 16;
+    uint32_t spins = 0;
+
+    while (l->t.owner != ticket) {
+        cpu_pause();
+        spins++;
+    }
+    /* Keep critical-section loads below the exit test (acquire) */
+    asm volatile ("" ::: "memory");
+    LOCK_ACQUIRED(l, spins, 1);
+}
+
+static inline void ticket_unlock(struct ticketlock *l) {
+    LOCK_RELEASED(l);
+    /* Only the holder writes owner; a 16-bit store leaves next alone */
+    asm volatile ("" ::: "memory");
+    l->t.owner++;
+}
+
+static inline uint32_t ticket_lock_irqsave(struct ticketlock *l) {
+    uint32_t flags = irq_save();
+    ticket_lock(l);
+    return flags;
+}
+
+static inline void ticket_unlock_irqrestore(struct ticketlock *l, uint32_t flags) {
+    ticket_unlock(l);
+    irq_restore(flags);
+}
+
+/* --- Reader-writer lock --- */
+
+static inline void read_lock(struct rwlock *l) {
+    uint32_t spins = 0;
+
+    for (;;) {
+        uint32_t v = l->count;
+        if (!(v & RW_WRITER) && atomic_cmpxchg(&l->count, v, v + 1))
+            break;
+        cpu_pause();
+        spins++;
+    }
+    LOCK_ACQUIRED(l, spins, 0);
+}
+
+static inline void read_unlock(struct rwlock *l) {
+    atomic_fetch_add(&l->count, (uint32_t)-1);
+}
+
+static inline void write_lock(struct rwlock *l) {
+    uint32_t spins = 0;
+
+    /* Claim the writer bit first so no new reader gets in, then drain */
+    for (;;) {
+        uint32_t v = l->count;
+        if (!(v & RW_WRITER) && atomic_cmpxchg(&l->count, v, v | RW_WRITER))
+            break;
+        cpu_pause();
+        spins++;
+    }
+    while (l->count & RW_READERS) {
+        cpu_pause();
+        spins++;
+    }
+    asm volatile ("" ::: "memory");
+    LOCK_ACQUIRED(l, spins, 1);
+}
+
+static inline void write_unlock(struct rwlock *l) {
+    LOCK_RELEASED(l);
+    asm volatile ("" ::: "memory");
+    l->count = 0;
+}
+
+/* Print the statistics of every lock used so far */
+void lock_print_stats(void);
+
+#endif /* LOCK_H */
@@ -0,0 +1,23 @@
+#ifndef MULTIBOOT_H
+#define MULTIBOOT_H
+
+#include "types.h"
+
+/* Value left in EAX by a multiboot compliant boot loader */
+#define MULTIBOOT_BOOTLOADER_MAGIC 0x2BADB002
+
+/* mem_lower/mem_upper are valid */
+#define MULTIBOOT_INFO_MEMORY 0x00000001
+
+/* Start of the information structure passed in EBX */
+struct multiboot_info {
+    uint32_t flags;
+    uint32_t mem_lower;     // KB of memory below 1MB
+    uint32_t mem_upper;     // KB of memory above 1MB
+    uint32_t boot_device;
+    uint32_t cmdline;
+    uint32_t mods_count;
+    uint32_t mods_addr;
+} __attribute__((packed));
+
+#endif /* MULTIBOOT_H */
@@ -0,0 +1,80 @@
+#ifndef PAGING_H
+#define PAGING_H
+
+#include "types.h"
+
+#define PAGE_SIZE 4096
+#define PAGE_MASK (~(PAGE_SIZE - 1))
+
+/* Page directory / table entry flags */
+#define PAGE_PRESENT 0x001
+#define PAGE_WRITE   0x002
+#define PAGE_USER    0x004
+
+/* Page fault error code bits */
+#define PF_PRESENT 0x1
+#define PF_WRITE   0x2
+#define PF_USER    0x4
+
+/* User programs live between the identity map and the anonymous window */
+#define USER_BASE       0x08000000
+#define USER_END        0x40000000
+#define USER_STACK_TOP  (USER_END - PAGE_SIZE)  // One unmapped page of gap
+#define USER_STACK_SIZE (64 * 1024)
+
+/* Second mapping of physical page 0 (the GDT), so the NULL page can go */
+#define GDT_ALIAS       0xFFFFF000
+
+/* Virtual window for lazily backed anonymous regions */
+#define VM_ANON_BASE    0x40000000
+#define VM_ANON_END     0x80000000
+#define VM_MAX_REGIONS  16
+
+/* An anonymous region: reserved up front, backed by frames on first touch */
+struct vm_region {
+    uint32_t start;
+    uint32_t end;
+    uint32_t flags;         // PAGE_WRITE and/or PAGE_USER
+    uint32_t resident;      // Private frames currently backing the region
+    int used;
+};
+
+/* Demand paging counters */
+struct pf_stats {
+    uint32_t zero_maps;     // Read faults served by the shared zero page
+    uint32_t anon_faults;   // Write faults on never-touched pages
+    uint32_t zero_upgrades; // Write faults on a page still on the zero page
+    uint64_t cycles;        // Cycles spent inside the fault handler
+    uint32_t max_cycles;
+};
+
+extern struct pf_stats pf_stats;
+
+/* Identity map [0, mem_top), install the #PF handler and enable paging */
+void init_paging(uint32_t mem_top);
+
+/* Map/unmap one 4KB page in the kernel page directory */
+int map_page(uint32_t virt, uint32_t phys, uint32_t flags);
+void unmap_page(uint32_t virt);
+
+/* Physical address behind virt, 0 if unmapped */
+uint32_t virt_to_phys(uint32_t virt);
+
+/* Reserve size bytes of address space without backing it; NULL on failure */
+void *vm_reserve(size_t size, uint32_t flags);
+
+/* Same, at a fixed page aligned address (used for user segments) */
+void *vm_reserve_at(uint32_t start, size_t size, uint32_t flags);
+
+/* Unmap a region and return its private frames to the allocator */
+void vm_release(void *addr);
+
+struct vm_region *vm_find_region(uint32_t addr);
+
+/* Print page fault counters and resident/reserved totals */
+void vm_print_stats(void);
+
+/* Touch sparse patterns in a large region and report resident vs reserved */
+void vm_stress(void);
+
+#endif /* PAGING_H */
@@ -0,0 +1,24 @@
+#ifndef PMM_H
+#define PMM_H
+
+#include "types.h"
+
+#define FRAME_SIZE 4096
+
+/* Physical memory handled by the frame allocator (all identity mapped) */
+#define PMM_MAX_MEMORY 0x08000000
+
+/* End of the kernel image, from linker.ld */
+extern uint8_t _kernel_end[];
+
+/* Mark [_kernel_end, mem_top) as free frames */
+void init_pmm(uint32_t mem_top);
+
+/* Allocate one frame; returns its physical address or 0 if memory is out */
+uint32_t pmm_alloc_frame(void);
+void pmm_free_frame(uint32_t frame);
+
+uint32_t pmm_free_frames(void);
+uint32_t pmm_total_frames(void);
+
+#endif /* PMM_H */
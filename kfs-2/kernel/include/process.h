@@ -0,0 +1,41 @@
+#ifndef PROCESS_H
+#define PROCESS_H
+
+#include "types.h"
+#include "idt.h"
+
+/* System call numbers (EAX), arguments in EBX and ECX (must match user/user.h) */
+#define SYS_EXIT  1
+#define SYS_WRITE 2
+
+/* A program embedded in the kernel image (see programs.asm) */
+struct program {
+    const char *name;
+    const uint8_t *image;
+    const uint8_t *image_end;
+};
+
+/* Kernel stack pointer saved by enter_user() while a program runs */
+struct user_context {
+    uint32_t esp;
+};
+
+/* Install the system call handler */
+void init_process(void);
+
+/* Load an embedded program, run it in ring 3 and return its exit code */
+int run_program(const char *name);
+
+/* Print the names of the embedded programs */
+void list_programs(void);
+
+/* Kill the running program after a fault in ring 3; returns only if no
+   program is running, in which case the caller handles the fault. addr is
+   the faulting address (CR2) for a page fault, NULL for other exceptions */
+void process_fault(struct regs *r, const char *what, const uint32_t *addr);
+
+/* usermode.asm: iret to ring 3 / unwind back into enter_user() */
+int enter_user(uint32_t eip, uint32_t esp, struct user_context *ctx);
+void leave_user(struct user_context *ctx, int code) __attribute__((noreturn));
+
+#endif /* PROCESS_H */
@@ -0,0 +1,51 @@
+#ifndef STACK_H
+#define STACK_H
+
+#include "types.h"
+
+/* Word written over every stack before first use (must match boot.asm) */
+#define STACK_PAINT 0xDEADBEEF
+
+/* Sizes shared with boot.asm */
+#define KERNEL_STACK_SIZE 16384
+#define IRQ_STACK_SIZE    4096
+#define DF_STACK_SIZE     4096
+#define STACK_GUARD_SIZE  4096
+#define MAX_STACKS        8
+
+/* A stack known to stackstat: [bottom, top) grows down from top */
+struct kstack {
+    const char *name;
+    uint32_t bottom;
+    uint32_t top;
+};
+
+/* Boot stack reserved in boot.asm (page aligned, painted before use) */
+extern uint8_t stack_bottom[];
+extern uint8_t stack_top[];
+
+/* Dedicated stacks for hardware interrupts and the double-fault task, also
+   reserved in boot.asm. Every boot.asm stack has a STACK_GUARD_SIZE guard
+   page directly below it */
+extern uint8_t irq_stack[];
+extern uint8_t df_stack[];
+
+/* Paint the IRQ/double-fault stacks and register every kernel stack */
+void init_stacks(void);
+
+/* Fill [bottom, top) with STACK_PAINT; only valid for a stack not in use */
+void stack_paint(void *bottom, void *top);
+
+/* Track a stack for stackstat. Returns 0 on success, -1 if the table is full */
+int stack_register(const char *name, void *bottom, void *top);
+
+/* Deepest number of bytes ever used on a painted stack */
+size_t stack_high_water(const struct kstack *s);
+
+/* Print size and peak usage of every registered stack */
+void stack_print_stats(void);
+
+/* Entry point of the double-fault task (runs on df_stack via a task gate) */
+void double_fault_task(void);
+
+#endif /* STACK_H */
@@ -0,0 +1,21 @@
+#ifndef TERMINAL_H
+#define TERMINAL_H
+
+#include "types.h"
+
+/* VGA text console (see main.c). All output takes the terminal lock */
+
+/* Clear the screen and home the cursor */
+void terminal_initialize(void);
+
+void terminal_putchar(char c);
+void terminal_write(const char* str);
+
+/* Unsigned numbers: hex without a prefix, decimal */
+void terminal_write_hex(uint32_t num);
+void terminal_write_dec(uint32_t num);
+
+/* Forcibly release the terminal lock before printing a fatal error */
+void terminal_break_lock(void);
+
+#endif /* TERMINAL_H */
@@ -0,0 +1,15 @@
+#ifndef TIMER_H
+#define TIMER_H
+
+#include "types.h"
+
+/* PIT input clock in Hz */
+#define PIT_FREQUENCY 1193182
+
+/* Program PIT channel 0 to fire IRQ0 at the given rate */
+void init_timer(uint32_t hz);
+
+/* Number of timer interrupts since init_timer() */
+uint32_t timer_ticks(void);
+
+#endif /* TIMER_H */
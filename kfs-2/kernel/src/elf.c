@@ -0,0 +1,153 @@
+#include "elf.h"
+#include "paging.h"
+#include "pmm.h"
+#include "terminal.h"
+
+/* Reason the image cannot be loaded, NULL if it looks sane */
+static const char *elf_check(const uint8_t *image, size_t size)
+{
+    const struct elf32_ehdr *eh = (const struct elf32_ehdr *)image;
+
+    if (size < sizeof(struct elf32_ehdr))
+        return "image too small";
+    if (eh->e_ident[0] != 0x7F || eh->e_ident[1] != 'E'
+        || eh->e_ident[2] != 'L' || eh->e_ident[3] != 'F')
+        return "not an ELF file";
+    if (eh->e_ident[4] != ELFCLASS32 || eh->e_ident[5] != ELFDATA2LSB)
+        return "not a 32-bit little-endian ELF";
+    if (eh->e_type != ET_EXEC || eh->e_machine != EM_386)
+        return "not an i386 executable";
+    if (eh->e_phentsize != sizeof(struct elf32_phdr)
+        || eh->e_phoff > size
+        || eh->e_phnum > (size - eh->e_phoff) / sizeof(struct elf32_phdr))
+        return "bad program header table";
+
+    for (int i = 0; i < eh->e_phnum; i++) {
+        const struct elf32_phdr *ph = (const struct elf32_phdr *)
+            (image + eh->e_phoff + i * sizeof(struct elf32_phdr));
+
+        if (ph->p_type != PT_LOAD || ph->p_memsz == 0)
+            continue;
+        if (ph->p_offset > size || ph->p_filesz > size - ph->p_offset)
+            return "segment outside the file";
+        if (ph->p_filesz > ph->p_memsz)
+            return "segment file size exceeds memory size";
+        if (ph->p_vaddr < USER_BASE
+            || ph->p_vaddr > USER_STACK_TOP - USER_STACK_SIZE
+            || ph->p_memsz > USER_STACK_TOP - USER_STACK_SIZE - ph->p_vaddr)
+            return "segment outside user space";
+    }
+    return NULL;
+}
+
+/* Copy the file bytes that fall in [page, page + PAGE_SIZE) to a new frame */
+static uint32_t elf_copy_page(const uint8_t *image, const struct elf32_phdr *ph,
+                              uint32_t page)
+{
+    uint32_t frame = pmm_alloc_frame();
+    uint32_t file_end = ph->p_vaddr + ph->p_filesz;
+    uint32_t lo = page < ph->p_vaddr ? ph->p_vaddr : page;
+    uint32_t hi = page + PAGE_SIZE < file_end ? page + PAGE_SIZE : file_end;
+    uint8_t *dst = (uint8_t *)frame;     // Frames are identity mapped
+
+    if (!frame)
+        return 0;
+    for (int i = 0; i < PAGE_SIZE; i++)
+        dst[i] = 0;
+    for (uint32_t a = lo; a < hi; a++)
+        dst[a - page] = image[ph->p_offset + (a - ph->p_vaddr)];
+    return frame;
+}
+
+static const char *elf_map_segment(const uint8_t *image, size_t size,
+                                   const struct elf32_phdr *ph,
+                                   struct elf_load_info *info)
+{
+    uint32_t start = ph->p_vaddr & PAGE_MASK;
+    uint32_t end = (ph->p_vaddr + ph->p_memsz + PAGE_SIZE - 1) & PAGE_MASK;
+    uint32_t file_end = ph->p_vaddr + ph->p_filesz;
+    uint32_t flags = PAGE_USER | ((ph->p_flags & PF_W) ? PAGE_WRITE : 0);
+    struct vm_region *reg;
+
+    /* Read-only pages can share the image's frames when the file offset
+       and the address agree on the page offset (as ld lays them out).
+       Like mmap, the bytes around the segment in a shared page come along */
+    int in_place = !(ph->p_flags & PF_W)
+        && ((uint32_t)image & ~PAGE_MASK) == 0
+        && ((ph->p_vaddr - ph->p_offset) & ~PAGE_MASK) == 0;
+
+    if (info->region_count == ELF_MAX_SEGMENTS)
+        return "too many segments";
+    if (!vm_reserve_at(start, end - start, flags))
+        return "segment overlaps another mapping";
+    info->regions[info->region_count++] = start;
+    info->reserved += end - start;
+    reg = vm_find_region(start);
+
+    /* Pages holding file data are mapped now; the .bss tail is demand paged */
+    for (uint32_t page = start; page < file_end; page += PAGE_SIZE) {
+        uint32_t offset = ph->p_offset - (ph->p_vaddr - page);
+        uint32_t frame;
+
+        /* A page that also holds .bss must be zeroed, so it is copied */
+        if (in_place && offset + PAGE_SIZE <= size
+            && (page + PAGE_SIZE <= file_end || ph->p_memsz == ph->p_filesz)) {
+            frame = (uint32_t)image + offset;
+            if (map_page(page, frame, PAGE_USER) < 0)
+                return "out of memory";
+            info->shared += PAGE_SIZE;
+            continue;
+        }
+
+        frame = elf_copy_page(image, ph, page);
+        if (!frame)
+            return "out of memory";
+        if (map_page(page, frame, flags) < 0) {
+            pmm_free_frame(frame);
+            return "out of memory";
+        }
+        reg->resident++;
+        info->copied += PAGE_SIZE;
+    }
+    return NULL;
+}
+
+int elf_load(const uint8_t *image, size_t size, struct elf_load_info *info)
+{
+    const struct elf32_ehdr *eh = (const struct elf32_ehdr *)image;
+    const char *err = elf_check(image, size);
+
+    info->entry = 0;
+    info->shared = 0;
+    info->copied = 0;
+    info->reserved = 0;
+    info->region_count = 0;
+
+    for (int i = 0; !err && i < eh->e_phnum; i++) {
+        const struct elf32_phdr *ph = (const struct elf32_phdr *)
+            (image + eh->e_phoff + i * sizeof(struct elf32_phdr));
+
+        if (ph->p_type == PT_LOAD && ph->p_memsz)
+            err = elf_map_segment(image, size, ph, info);
+    }
+    if (!err && !vm_find_region(eh->e_entry))
+        err = "entry point is not in a loaded segment";
+
+    if (err) {
+        elf_unload(info);
+        terminal_write("elf: ");
+        terminal_write(err);
+        terminal_write("\n");
+        return -1;
+    }
+
+    info->entry = eh->e_entry;
+    return 0;
+}
+
+void elf_unload(struct elf_load_info *info)
+{
+    for (int i = 0; i < info->region_count; i++)
+        vm_release((void *)info->regions[i]);
+    info->region_count = 0;
+}
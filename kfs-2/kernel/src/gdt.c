@@ -1,10 +1,14 @@
 #include "gdt.h"
+#include "stack.h"
 
-/* Define 7 entries (0=Null, 1=Kernel Code, 2=Kernel Data, 3=Kernel Stack, 
-   4=User Code, 5=User Data, 6=User Stack) */
-struct gdt_entry gdt_entries[7] __attribute__((section(".gdt")));
+/* Define 9 entries (0=Null, 1=Kernel Code, 2=Kernel Data, 3=Kernel Stack, 
+   4=User Code, 5=User Data, 6=User Stack, 7=Kernel TSS, 8=Double Fault TSS) */
+struct gdt_entry gdt_entries[GDT_ENTRIES] __attribute__((section(".gdt")));
 struct gdt_ptr gdt_ptr __attribute__((section(".gdt")));
 
+struct tss_entry kernel_tss;
+struct tss_entry df_tss;
+
 /* Set an individual GDT entry */
 static void gdt_set_gate(int num, unsigned long base, unsigned long limit, 
                          uint8_t access, uint8_t gran)
@@ -20,11 +24,42 @@ static void gdt_set_gate(int num, unsigned long base, unsigned long limit,
     gdt_entries[num].access      = access;
 }
 
+/* Set up the task the double fault task gate switches to */
+static void init_tss(void)
+{
+    uint8_t *p;
+    uint32_t cr3;
+
+    for (p = (uint8_t *)&kernel_tss; p < (uint8_t *)(&kernel_tss + 1); p++)
+        *p = 0;
+    for (p = (uint8_t *)&df_tss; p < (uint8_t *)(&df_tss + 1); p++)
+        *p = 0;
+
+    kernel_tss.ss0 = GDT_KERNEL_DATA_SEL;
+    kernel_tss.esp0 = (uint32_t)stack_top;
+    kernel_tss.iomap_base = sizeof(struct tss_entry);
+
+    asm volatile("movl %%cr3, %0" : "=r"(cr3));
+
+    /* A fresh flat stack: the faulting one may be the one that overflowed */
+    df_tss.cr3 = cr3;
+    df_tss.eip = (uint32_t)double_fault_task;
+    df_tss.eflags = 0x2;
+    df_tss.esp = (uint32_t)(df_stack + DF_STACK_SIZE);
+    df_tss.cs = GDT_KERNEL_CODE_SEL;
+    df_tss.ss = GDT_KERNEL_DATA_SEL;
+    df_tss.ds = GDT_KERNEL_DATA_SEL;
+    df_tss.es = GDT_KERNEL_DATA_SEL;
+    df_tss.fs = GDT_KERNEL_DATA_SEL;
+    df_tss.gs = GDT_KERNEL_DATA_SEL;
+    df_tss.iomap_base = sizeof(struct tss_entry);
+}
+
 /* Initialize and load our GDT */
 void init_gdt(void)
 {
-    /* There are 7 entries */
-    gdt_ptr.limit = (sizeof(struct gdt_entry) * 7) - 1;
+    /* There are GDT_ENTRIES entries */
+    gdt_ptr.limit = (sizeof(struct gdt_entry) * GDT_ENTRIES) - 1;
     gdt_ptr.base = (unsigned int)&gdt_entries;
 
     /* Null segment */
@@ -48,6 +83,12 @@ void init_gdt(void)
     /* User Stack Segment: same as user data */
     gdt_set_gate(6, 0, 0xFFFFFFFF, 0xF2, 0xCF);
 
+
+    /* Task State Segments: access=0x89 (present, 32-bit available TSS) */
+    init_tss();
+    gdt_set_gate(7, (uint32_t)&kernel_tss, sizeof(struct tss_entry) - 1, 0x89, 0x00);
+    gdt_set_gate(8, (uint32_t)&df_tss, sizeof(struct tss_entry) - 1, 0x89, 0x00);
+
     /* Load the new GDT using LGDT */
     asm volatile("lgdt (%0)" : : "r" (&gdt_ptr));
 
@@ -68,4 +109,15 @@ void init_gdt(void)
         "ljmp $0x08, $.flush\n"
         ".flush:\n"
     );
+
+    /* Load the task register (0x38 == Kernel TSS, index 7 * 8) so the CPU
+       has somewhere to save state when the double fault gate switches away */
+    asm volatile("ltr %%ax" : : "a"((uint16_t)GDT_TSS_SEL));
+}
+
+/* Loaded segment registers keep their cached descriptors across the reload */
+void gdt_relocate(uint32_t base)
+{
+    gdt_ptr.base = base;
+    asm volatile("lgdt (%0)" : : "r" (&gdt_ptr));
 }
@@ -0,0 +1,136 @@
+#include "idt.h"
+#include "gdt.h"
+#include "keyboard.h"
+#include "process.h"
+#include "terminal.h"
+
+/* 8259 PIC ports and commands */
+#define PIC1_COMMAND 0x20
+#define PIC1_DATA    0x21
+#define PIC2_COMMAND 0xA0
+#define PIC2_DATA    0xA1
+#define PIC_EOI      0x20
+
+/* Gate types: 0x8E = present ring-0 interrupt gate, 0xEE = same but
+   reachable with INT from ring 3, 0x85 = task gate */
+#define IDT_INTERRUPT_GATE      0x8E
+#define IDT_USER_INTERRUPT_GATE 0xEE
+#define IDT_TASK_GATE           0x85
+
+/* Addresses of isr0..isr31 followed by irq0..irq15 (interrupt.asm) */
+extern uint32_t isr_stub_table[];
+extern void isr128(void);
+
+static struct idt_entry idt_entries[IDT_ENTRIES];
+static struct idt_ptr idt_ptr;
+static isr_t interrupt_handlers[IDT_ENTRIES];
+
+static const char *exception_names[32] = {
+    "Divide Error", "Debug", "NMI", "Breakpoint", "Overflow",
+    "Bound Range Exceeded", "Invalid Opcode", "Device Not Available",
+    "Double Fault", "Coprocessor Segment Overrun", "Invalid TSS",
+    "Segment Not Present", "Stack-Segment Fault", "General Protection",
+    "Page Fault", "Reserved", "x87 Floating-Point", "Alignment Check",
+    "Machine Check", "SIMD Floating-Point", "Virtualization",
+    "Control Protection", "Reserved", "Reserved", "Reserved", "Reserved",
+    "Reserved", "Reserved", "Reserved", "Reserved", "Security", "Reserved"
+};
+
+/* Set an individual IDT gate */
+static void idt_set_gate(uint8_t num, uint32_t base, uint16_t sel, uint8_t flags)
+{
+    idt_entries[num].base_low  = base & 0xFFFF;
+    idt_entries[num].base_high = (base >> 16) & 0xFFFF;
+    idt_entries[num].sel       = sel;
+    idt_entries[num].always0   = 0;
+    idt_entries[num].flags     = flags;
+}
+
+/* Remap IRQ 0-15 to vectors 32-47 and mask them all */
+static void pic_remap(void)
+{
+    outb(PIC1_COMMAND, 0x11);   // ICW1: init, expect ICW4
+    outb(PIC2_COMMAND, 0x11);
+    outb(PIC1_DATA, IRQ_BASE);  // ICW2: vector offsets
+    outb(PIC2_DATA, IRQ_BASE + 8);
+    outb(PIC1_DATA, 0x04);      // ICW3: slave on IRQ2
+    outb(PIC2_DATA, 0x02);
+    outb(PIC1_DATA, 0x01);      // ICW4: 8086 mode
+    outb(PIC2_DATA, 0x01);
+
+    /* Everything masked except the cascade line */
+    outb(PIC1_DATA, 0xFB);
+    outb(PIC2_DATA, 0xFF);
+}
+
+void irq_unmask(uint8_t irq)
+{
+    uint16_t port = irq < 8 ? PIC1_DATA : PIC2_DATA;
+
+    outb(port, inb(port) & ~(1 << (irq & 7)));
+}
+
+void register_interrupt_handler(uint8_t n, isr_t handler)
+{
+    interrupt_handlers[n] = handler;
+}
+
+/* CPU exceptions and software interrupts: run on the interrupted stack */
+void isr_handler(struct regs *r)
+{
+    if (interrupt_handlers[r->int_no]) {
+        interrupt_handlers[r->int_no](r);
+        return;
+    }
+
+    /* A faulting user program is killed, the kernel carries on */
+    if ((r->cs & 3) == 3)
+        process_fault(r, r->int_no < 32 ? exception_names[r->int_no] : "Unknown",
+                      NULL);
+
+    terminal_break_lock();
+    terminal_write("\n*** EXCEPTION: ");
+    terminal_write(r->int_no < 32 ? exception_names[r->int_no] : "Unknown");
+    terminal_write(" (vector 0x");
+    terminal_write_hex(r->int_no);
+    terminal_write(", error 0x");
+    terminal_write_hex(r->err_code);
+    terminal_write(") at EIP 0x");
+    terminal_write_hex(r->eip);
+    terminal_write(" ***\n");
+
+    while (1) {
+        asm volatile("cli; hlt");
+    }
+}
+
+/* Hardware IRQs: the stub has already switched to the IRQ stack */
+void irq_handler(struct regs *r)
+{
+    if (interrupt_handlers[r->int_no])
+        interrupt_handlers[r->int_no](r);
+
+    if (r->int_no >= IRQ_BASE + 8)
+        outb(PIC2_COMMAND, PIC_EOI);
+    outb(PIC1_COMMAND, PIC_EOI);
+}
+
+void init_idt(void)
+{
+    idt_ptr.limit = sizeof(struct idt_entry) * IDT_ENTRIES - 1;
+    idt_ptr.base = (uint32_t)&idt_entries;
+
+    for (int i = 0; i < 48; i++)
+        idt_set_gate(i, isr_stub_table[i], GDT_KERNEL_CODE_SEL, IDT_INTERRUPT_GATE);
+
+    /* #DF switches task so it still works when the kernel stack is gone */
+    idt_set_gate(8, 0, GDT_DF_TSS_SEL, IDT_TASK_GATE);
+
+    /* System calls are the only gate user code may invoke directly */
+    idt_set_gate(SYSCALL_VECTOR, (uint32_t)isr128, GDT_KERNEL_CODE_SEL,
+                 IDT_USER_INTERRUPT_GATE);
+
+    pic_remap();
+
+    asm volatile("lidt (%0)" : : "r" (&idt_ptr));
+}
@@ -0,0 +1,162 @@
+; Interrupt entry stubs: push a uniform frame (see struct regs in idt.h)
+; and hand it to the C dispatchers in idt.c.
+
+KERNEL_DATA_SEL equ 0x10
+IRQ_STACK_SIZE  equ 4096    ; must match kernel/include/stack.h
+
+extern isr_handler
+extern irq_handler
+extern irq_stack
+
+; Exceptions without a CPU error code push a dummy one
+%macro ISR_NOERR 1
+isr%1:
+    push dword 0
+    push dword %1
+    jmp isr_common_stub
+%endmacro
+
+%macro ISR_ERR 1
+isr%1:
+    push dword %1
+    jmp isr_common_stub
+%endmacro
+
+; IRQ number, vector
+%macro IRQ 2
+irq%1:
+    push dword 0
+    push dword %2
+    jmp irq_common_stub
+%endmacro
+
+section .text
+
+ISR_NOERR 0
+ISR_NOERR 1
+ISR_NOERR 2
+ISR_NOERR 3
+ISR_NOERR 4
+ISR_NOERR 5
+ISR_NOERR 6
+ISR_NOERR 7
+ISR_ERR   8
+ISR_NOERR 9
+ISR_ERR   10
+ISR_ERR   11
+ISR_ERR   12
+ISR_ERR   13
+ISR_ERR   14
+ISR_NOERR 15
+ISR_NOERR 16
+ISR_ERR   17
+ISR_NOERR 18
+ISR_NOERR 19
+ISR_NOERR 20
+ISR_ERR   21
+ISR_NOERR 22
+ISR_NOERR 23
+ISR_NOERR 24
+ISR_NOERR 25
+ISR_NOERR 26
+ISR_NOERR 27
+ISR_NOERR 28
+ISR_NOERR 29
+ISR_ERR   30
+ISR_NOERR 31
+
+; System call gate (DPL 3)
+global isr128
+ISR_NOERR 128
+
+IRQ 0, 32
+IRQ 1, 33
+IRQ 2, 34
+IRQ 3, 35
+IRQ 4, 36
+IRQ 5, 37
+IRQ 6, 38
+IRQ 7, 39
+IRQ 8, 40
+IRQ 9, 41
+IRQ 10, 42
+IRQ 11, 43
+IRQ 12, 44
+IRQ 13, 45
+IRQ 14, 46
+IRQ 15, 47
+
+; Exceptions and software interrupts stay on the interrupted stack
+isr_common_stub:
+    pusha
+    push ds
+    push es
+    push fs
+    push gs
+
+    mov ax, KERNEL_DATA_SEL
+    mov ds, ax
+    mov es, ax
+    mov fs, ax
+    mov gs, ax
+
+    push esp                ; struct regs *
+    call isr_handler
+    add esp, 4
+
+    pop gs
+    pop fs
+    pop es
+    pop ds
+    popa
+    add esp, 8              ; int_no, err_code
+    iret
+
+; Hardware IRQs run on the dedicated IRQ stack, so the interrupted code
+; never has to budget stack space for them. A nested IRQ (already on the
+; IRQ stack) keeps using it.
+irq_common_stub:
+    pusha
+    push ds
+    push es
+    push fs
+    push gs
+
+    mov ax, KERNEL_DATA_SEL
+    mov ds, ax
+    mov es, ax
+    mov fs, ax
+    mov gs, ax
+
+    mov ebx, esp            ; struct regs * on the interrupted stack
+    mov eax, esp
+    sub eax, irq_stack
+    cmp eax, IRQ_STACK_SIZE
+    jb .on_irq_stack        ; ESP already inside [irq_stack, +size)
+    mov esp, irq_stack + IRQ_STACK_SIZE
+.on_irq_stack:
+    push ebx
+    call irq_handler
+    mov esp, ebx            ; EBX is callee-saved, and restored by popa
+
+    pop gs
+    pop fs
+    pop es
+    pop ds
+    popa
+    add esp, 8              ; int_no, err_code
+    iret
+
+section .data
+global isr_stub_table
+isr_stub_table:
+%assign i 0
+%rep 32
+    dd isr%[i]
+%assign i i+1
+%endrep
+%assign i 0
+%rep 16
+    dd irq%[i]
+%assign i i+1
+%endrep
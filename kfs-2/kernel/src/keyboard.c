@@ -1,4 +1,5 @@
 #include "keyboard.h"
+#include "terminal.h"
 
 // Simple scancode to ASCII mapping
 static const char scancode_to_ascii[] = {
@@ -9,9 +10,6 @@ static const char scancode_to_ascii[] = {
     '*', 0, ' '
 };
 
-// External function to write character (defined in main.c)
-extern void terminal_putchar(char c);
-
 void keyboard_handler(void) {
     uint8_t scancode = inb(KEYBOARD_DATA_PORT);
     
@@ -0,0 +1,77 @@
+#include "lock.h"
+#include "terminal.h"
+
+#ifdef LOCK_DEBUG
+
+/* Locks register themselves on first acquisition (lock-free push) */
+static struct lock_stats *volatile lock_list;
+
+static void lock_stats_register(struct lock_stats *s)
+{
+    struct lock_stats *head;
+
+    if (atomic_xchg(&s->registered, 1))
+        return;
+    do {
+        head = lock_list;
+        s->next = head;
+    } while (!atomic_cmpxchg((volatile uint32_t *)&lock_list,
+                             (uint32_t)head, (uint32_t)s));
+}
+
+/* Counters of exclusive locks are only touched by the holder; shared
+   (reader) acquisitions can race, so those use atomic adds */
+void lock_stats_acquired(struct lock_stats *s, uint32_t spins, int exclusive)
+{
+    if (!s->registered)
+        lock_stats_register(s);
+
+    if (exclusive) {
+        s->acquisitions++;
+        if (spins) {
+            s->contended++;
+            s->spins += spins;
+        }
+        s->acquired_at = rdtsc();
+        return;
+    }
+
+    atomic_fetch_add(&s->acquisitions, 1);
+    if (spins) {
+        atomic_fetch_add(&s->contended, 1);
+        atomic_fetch_add(&s->spins, spins);
+    }
+}
+
+void lock_stats_released(struct lock_stats *s)
+{
+    uint32_t held = (uint32_t)(rdtsc() - s->acquired_at);
+
+    if (held > s->max_hold)
+        s->max_hold = held;
+}
+
+void lock_print_stats(void)
+{
+    for (struct lock_stats *s = lock_list; s; s = s->next) {
+        terminal_write(s->name);
+        terminal_write(": ");
+        terminal_write_dec(s->acquisitions);
+        terminal_write(" acquired, ");
+        terminal_write_dec(s->contended);
+        terminal_write(" contended (");
+        terminal_write_dec(s->spins);
+        terminal_write(" spins), max hold ");
+        terminal_write_dec(s->max_hold);
+        terminal_write(" cycles\n");
+    }
+}
+
+#else
+
+void lock_print_stats(void)
+{
+    terminal_write("Lock statistics are off (rebuild with make LOCK_DEBUG=1)\n");
+}
+
+#endif /* LOCK_DEBUG */
@@ -2,16 +2,32 @@
 #include "vga.h"
 #include "keyboard.h"
 #include "gdt.h"
+#include "idt.h"
+#include "stack.h"
+#include "timer.h"
+#include "multiboot.h"
+#include "pmm.h"
+#include "paging.h"
+#include "process.h"
+#include "lock.h"
 #include "shell.h"
+#include "terminal.h"
 
 static uint16_t* const VGA_MEMORY = (uint16_t*)0xB8000;
 static const size_t VGA_WIDTH = 80;
 static const size_t VGA_HEIGHT = 25;
 
+/* Assumed RAM size when the boot loader gives no memory information */
+#define DEFAULT_MEMORY (32 * 1024 * 1024)
+
 static size_t terminal_row;
 static size_t terminal_column;
 static uint8_t terminal_color;
 
+/* Serializes the cursor and VGA buffer; taken with IRQs off since
+   interrupt and fault handlers print too */
+static struct ticketlock terminal_lock = TICKETLOCK_INIT("terminal");
+
 const char* HEADER[] = {
     "    AAAA    N   N  TTTTT  H   H  RRRR   OOO  DDDD   RRRR  ",
     "   A    A   NN  N    T    H   H  R   R O   O D   D  R   R ",
@@ -24,10 +40,7 @@ const char* HEADER[] = {
     NULL
 };
 
-/* Make terminal_putchar visible to other files */
-void terminal_putchar(char c);
-
-void terminal_initialize(void) 
+static void terminal_clear(void) 
 {
     terminal_row = 0;
     terminal_column = 0;
@@ -48,6 +61,20 @@ static void terminal_putchar_at(char c, uint8_t color, size_t x, size_t y)
     VGA_MEMORY[index] = vga_entry(c, color);
 }
 
+void terminal_initialize(void) 
+{
+    uint32_t flags = ticket_lock_irqsave(&terminal_lock);
+    terminal_clear();
+    ticket_unlock_irqrestore(&terminal_lock, flags);
+}
+
+/* A fatal fault may have interrupted a holder of the terminal lock;
+   drop it so the panic message still gets out */
+void terminal_break_lock(void)
+{
+    terminal_lock.word = 0;
+}
+
 static size_t strlen(const char* str) {
     size_t len = 0;
     while (str[len])
@@ -55,7 +82,7 @@ static size_t strlen(const char* str) {
     return len;
 }
 
-void terminal_putchar(char c) 
+static void terminal_putchar_locked(char c) 
 {
     if (c == '\n') {
         terminal_column = 0;
@@ -74,10 +101,19 @@ void terminal_putchar(char c)
     }
 }
 
+void terminal_putchar(char c) 
+{
+    uint32_t flags = ticket_lock_irqsave(&terminal_lock);
+    terminal_putchar_locked(c);
+    ticket_unlock_irqrestore(&terminal_lock, flags);
+}
+
 void terminal_write(const char* str) 
 {
+    uint32_t flags = ticket_lock_irqsave(&terminal_lock);
     for (size_t i = 0; str[i] != '\0'; i++)
-        terminal_putchar(str[i]);
+        terminal_putchar_locked(str[i]);
+    ticket_unlock_irqrestore(&terminal_lock, flags);
 }
 
 static void terminal_writestr_centered(const char* str, size_t row) 
@@ -100,15 +136,18 @@ static void terminal_writestr_centered(const char* str, size_t row)
 
 static void print_header(void)
 {
+    uint32_t flags = ticket_lock_irqsave(&terminal_lock);
+
     for (size_t i = 0; HEADER[i] != NULL; i++) {
         terminal_writestr_centered(HEADER[i], i);
     }
     terminal_row = 10;
     terminal_column = 0;
+    ticket_unlock_irqrestore(&terminal_lock, flags);
 }
 
 /* Utility: Print a 32-bit number in hexadecimal */
-static void print_hex(uint32_t num) {
+void terminal_write_hex(uint32_t num) {
     char hex_chars[] = "0123456789ABCDEF";
     char str[9];
     str[8] = '\0';
@@ -119,7 +158,19 @@ static void print_hex(uint32_t num) {
     terminal_write(str);
 }
 
-/* Print the current kernel stack pointer (ESP) */
+/* Utility: Print a 32-bit number in decimal */
+void terminal_write_dec(uint32_t num) {
+    char str[11];
+    int i = 10;
+    str[i] = '\0';
+    do {
+        str[--i] = '0' + num % 10;
+        num /= 10;
+    } while (num);
+    terminal_write(&str[i]);
+}
+
+/* Print the current kernel stack pointer (ESP) and the stack bounds */
 static void print_kernel_stack(void)
 {
     uint32_t esp;
@@ -128,22 +179,52 @@ static void print_kernel_stack(void)
     asm volatile("movl %%esp, %0" : "=r"(esp) : : "memory");
 
     terminal_write("\nKernel stack pointer (ESP): 0x");
-    print_hex(esp);
-    terminal_write("\n");
-    
+    terminal_write_hex(esp);
+    terminal_write("\nKernel stack: 0x");
+    terminal_write_hex((uint32_t)stack_bottom);
+    terminal_write("-0x");
+    terminal_write_hex((uint32_t)stack_top);
+    terminal_write(" (");
+    terminal_write_dec((uint32_t)stack_top - esp);
+    terminal_write(" bytes in use)\n");
 }
 
 
-void kernel_main(void) 
+/* Top of usable physical memory as reported by the boot loader */
+static uint32_t detect_memory(uint32_t magic, const struct multiboot_info *mbi)
 {
+    if (magic == MULTIBOOT_BOOTLOADER_MAGIC && (mbi->flags & MULTIBOOT_INFO_MEMORY))
+        return (mbi->mem_upper + 1024) * 1024;
+    return DEFAULT_MEMORY;
+}
+
+void kernel_main(uint32_t magic, const struct multiboot_info *mbi) 
+{
+    uint32_t mem_top = detect_memory(magic, mbi);
+    uint32_t flags;
+
     terminal_initialize();
     
     /* Initialize the Global Descriptor Table */
     init_gdt();
 
+    /* Paint the IRQ/double-fault stacks, then route interrupts to them */
+    init_stacks();
+    init_idt();
+
+    /* Frame allocator, then identity paging with demand-paged regions */
+    init_pmm(mem_top);
+    init_paging(mem_top);
+    init_process();
+
+    init_timer(100);
+    asm volatile("sti");
+
     print_header();
     
+    flags = ticket_lock_irqsave(&terminal_lock);
     terminal_color = vga_entry_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK);
+    ticket_unlock_irqrestore(&terminal_lock, flags);
     
     terminal_write("\nWelcome to KFS-2!\n");
     terminal_write("42 School Kernel From Scratch - v2.0\n\n");
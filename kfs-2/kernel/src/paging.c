@@ -0,0 +1,520 @@
+#include "paging.h"
+#include "pmm.h"
+#include "idt.h"
+#include "gdt.h"
+#include "cpu.h"
+#include "process.h"
+#include "lock.h"
+#include "stack.h"
+#include "terminal.h"
+
+static uint32_t page_directory[1024] __attribute__((aligned(PAGE_SIZE)));
+static struct vm_region regions[VM_MAX_REGIONS];
+
+/* Lock order: vm_lock before pt_lock */
+static struct rwlock vm_lock = RWLOCK_INIT("vm regions");
+static struct spinlock pt_lock = SPINLOCK_INIT("page tables");
+
+/* Guards the pf_stats cycle total and maximum; the counters are atomic */
+static struct spinlock pf_stats_lock = SPINLOCK_INIT("pf stats");
+
+/* Every untouched page of every region reads through this one frame */
+static uint32_t zero_page;
+
+struct pf_stats pf_stats;
+
+static void zero_frame(uint32_t frame)
+{
+    /* Frames are identity mapped */
+    uint32_t *p = (uint32_t *)frame;
+
+    for (int i = 0; i < PAGE_SIZE / 4; i++)
+        p[i] = 0;
+}
+
+static inline void invlpg(uint32_t virt)
+{
+    asm volatile("invlpg (%0)" : : "r"(virt) : "memory");
+}
+
+/* Page table entry for virt, allocating its page table if create is set */
+static uint32_t *get_pte(uint32_t virt, int create, uint32_t flags)
+{
+    uint32_t *pde = &page_directory[virt >> 22];
+
+    if (!(*pde & PAGE_PRESENT)) {
+        uint32_t table;
+
+        if (!create)
+            return NULL;
+        table = pmm_alloc_frame();
+        if (!table)
+            return NULL;
+        zero_frame(table);
+        *pde = table | PAGE_PRESENT | PAGE_WRITE;
+    }
+    /* User access must be allowed at both levels */
+    *pde |= flags & PAGE_USER;
+
+    return &((uint32_t *)(*pde & PAGE_MASK))[(virt >> 12) & 0x3FF];
+}
+
+int map_page(uint32_t virt, uint32_t phys, uint32_t flags)
+{
+    uint32_t irq = spin_lock_irqsave(&pt_lock);
+    uint32_t *pte = get_pte(virt, 1, flags);
+
+    if (pte) {
+        *pte = (phys & PAGE_MASK) | (flags & 0xFFF) | PAGE_PRESENT;
+        invlpg(virt);
+    }
+    spin_unlock_irqrestore(&pt_lock, irq);
+    return pte ? 0 : -1;
+}
+
+/*
+ * Install virt -> phys only if virt still maps expect (0: not present),
+ * re-checked under pt_lock. Returns 1 if another fault changed the entry
+ * first, -1 if the page table cannot be allocated.
+ */
+static int map_page_if(uint32_t virt, uint32_t expect, uint32_t phys,
+                       uint32_t flags)
+{
+    uint32_t irq = spin_lock_irqsave(&pt_lock);
+    uint32_t *pte = get_pte(virt, 1, flags);
+    int ret = -1;
+
+    if (pte) {
+        uint32_t cur = (*pte & PAGE_PRESENT) ? (*pte & PAGE_MASK) : 0;
+
+        ret = 1;
+        if (cur == expect) {
+            *pte = (phys & PAGE_MASK) | (flags & 0xFFF) | PAGE_PRESENT;
+            invlpg(virt);
+            ret = 0;
+        }
+    }
+    spin_unlock_irqrestore(&pt_lock, irq);
+    return ret;
+}
+
+void unmap_page(uint32_t virt)
+{
+    uint32_t irq = spin_lock_irqsave(&pt_lock);
+    uint32_t *pte = get_pte(virt, 0, 0);
+
+    if (pte && (*pte & PAGE_PRESENT)) {
+        *pte = 0;
+        invlpg(virt);
+    }
+    spin_unlock_irqrestore(&pt_lock, irq);
+}
+
+/* Current page table entry for virt, 0 if it has no page table yet */
+static uint32_t pte_entry(uint32_t virt)
+{
+    uint32_t *pte = get_pte(virt, 0, 0);
+
+    return pte ? *pte : 0;
+}
+
+uint32_t virt_to_phys(uint32_t virt)
+{
+    uint32_t pte = pte_entry(virt);
+
+    if (!(pte & PAGE_PRESENT))
+        return 0;
+    return (pte & PAGE_MASK) | (virt & ~PAGE_MASK);
+}
+
+/* Callers hold vm_lock */
+static struct vm_region *vm_lookup(uint32_t addr)
+{
+    for (int i = 0; i < VM_MAX_REGIONS; i++) {
+        if (regions[i].used && addr >= regions[i].start && addr < regions[i].end)
+            return &regions[i];
+    }
+    return NULL;
+}
+
+struct vm_region *vm_find_region(uint32_t addr)
+{
+    struct vm_region *r;
+
+    read_lock(&vm_lock);
+    r = vm_lookup(addr);
+    read_unlock(&vm_lock);
+    return r;
+}
+
+/* First region overlapping [start, end), if any */
+static struct vm_region *vm_find_overlap(uint32_t start, uint32_t end)
+{
+    for (int i = 0; i < VM_MAX_REGIONS; i++) {
+        if (regions[i].used && start < regions[i].end && regions[i].start < end)
+            return &regions[i];
+    }
+    return NULL;
+}
+
+/* Claim a free slot for [start, start + size); callers hold vm_lock */
+static void *vm_region_add(uint32_t start, size_t size, uint32_t flags)
+{
+    for (int i = 0; i < VM_MAX_REGIONS; i++) {
+        if (regions[i].used)
+            continue;
+
+        /* Nothing is mapped: frames arrive through page_fault_handler */
+        regions[i].start = start;
+        regions[i].end = start + size;
+        regions[i].flags = flags & (PAGE_WRITE | PAGE_USER);
+        regions[i].resident = 0;
+        regions[i].used = 1;
+        return (void *)start;
+    }
+    return NULL;
+}
+
+void *vm_reserve(size_t size, uint32_t flags)
+{
+    struct vm_region *conflict;
+    uint32_t start = VM_ANON_BASE;
+    void *addr = NULL;
+
+    size = (size + PAGE_SIZE - 1) & PAGE_MASK;
+    if (size == 0 || size > VM_ANON_END - VM_ANON_BASE)
+        return NULL;
+
+    write_lock(&vm_lock);
+
+    /* First fit: step past every region in the way */
+    while ((conflict = vm_find_overlap(start, start + size)) != NULL) {
+        start = conflict->end;
+        if (start > VM_ANON_END - size)
+            break;
+    }
+    if (!conflict)
+        addr = vm_region_add(start, size, flags);
+
+    write_unlock(&vm_lock);
+    return addr;
+}
+
+void *vm_reserve_at(uint32_t start, size_t size, uint32_t flags)
+{
+    void *addr;
+
+    size = (size + PAGE_SIZE - 1) & PAGE_MASK;
+    if (size == 0 || (start & ~PAGE_MASK) || start < USER_BASE
+        || start >= VM_ANON_END || size > VM_ANON_END - start)
+        return NULL;
+
+    write_lock(&vm_lock);
+    addr = vm_find_overlap(start, start + size) ? NULL
+         : vm_region_add(start, size, flags);
+    write_unlock(&vm_lock);
+    return addr;
+}
+
+void vm_release(void *addr)
+{
+    struct vm_region *r;
+
+    write_lock(&vm_lock);
+    r = vm_lookup((uint32_t)addr);
+    if (!r) {
+        write_unlock(&vm_lock);
+        return;
+    }
+
+    for (uint32_t page = r->start; page < r->end; page += PAGE_SIZE) {
+        uint32_t phys = virt_to_phys(page);
+
+        if (phys && phys != zero_page)
+            pmm_free_frame(phys);
+        unmap_page(page);
+    }
+    r->used = 0;
+    write_unlock(&vm_lock);
+}
+
+static void page_fault_fatal(struct regs *r, uint32_t addr, const char *why)
+{
+    /* A bad user access only kills the program */
+    if ((r->cs & 3) == 3)
+        process_fault(r, "page fault", &addr);
+
+    terminal_break_lock();
+    terminal_write("\n*** PAGE FAULT: ");
+    terminal_write(why);
+    terminal_write(" at 0x");
+    terminal_write_hex(addr);
+    terminal_write(" (error 0x");
+    terminal_write_hex(r->err_code);
+    terminal_write(") EIP 0x");
+    terminal_write_hex(r->eip);
+    terminal_write(" ***\n");
+
+    while (1) {
+        asm volatile("cli; hlt");
+    }
+}
+
+/*
+ * Back anonymous regions lazily: a read of an untouched page maps the
+ * shared zero page read-only, a write (first touch or on the zero page)
+ * gets a fresh zeroed frame. CR0.WP makes ring-0 writes fault too.
+ * Called with vm_lock read-held so the region cannot be released under
+ * us; returns why the fault is fatal, or NULL once the page is mapped.
+ *
+ * Other faulters may hold vm_lock for read too and race us on the same
+ * page, so the entry is re-checked when it is installed: whoever loses
+ * gives its frame back and simply retries the access.
+ */
+static const char *page_fault_resolve(struct regs *r, uint32_t addr)
+{
+    uint32_t page = addr & PAGE_MASK;
+    struct vm_region *reg = vm_lookup(addr);
+    uint32_t pte;
+    uint32_t cur;
+    int ret;
+
+    if (!reg)
+        return "unmapped address";
+    if ((r->err_code & PF_USER) && !(reg->flags & PAGE_USER))
+        return "user access to kernel region";
+
+    pte = pte_entry(page);
+    cur = (pte & PAGE_PRESENT) ? (pte & PAGE_MASK) : 0;
+
+    if (r->err_code & PF_WRITE) {
+        uint32_t frame;
+
+        if (!(reg->flags & PAGE_WRITE))
+            return "write protection";
+        /* Writable by now: a racing fault already served this write */
+        if (cur && (pte & PAGE_WRITE))
+            return NULL;
+        if (cur && cur != zero_page)
+            return "write protection";
+
+        frame = pmm_alloc_frame();
+        if (!frame)
+            return "out of memory";
+        zero_frame(frame);
+
+        ret = map_page_if(page, cur, frame, reg->flags);
+        if (ret) {
+            pmm_free_frame(frame);
+            return ret < 0 ? "out of memory" : NULL;
+        }
+        atomic_fetch_add(&reg->resident, 1);
+        atomic_fetch_add(cur ? &pf_stats.zero_upgrades : &pf_stats.anon_faults, 1);
+    } else {
+        if (r->err_code & PF_PRESENT)
+            return "protection violation";
+        if (cur)
+            return NULL;
+
+        ret = map_page_if(page, 0, zero_page, reg->flags & ~PAGE_WRITE);
+        if (ret < 0)
+            return "out of memory";
+        if (ret == 0)
+            atomic_fetch_add(&pf_stats.zero_maps, 1);
+    }
+    return NULL;
+}
+
+static void page_fault_handler(struct regs *r)
+{
+    uint64_t start = rdtsc();
+    uint32_t addr;
+    uint32_t elapsed;
+    uint32_t flags;
+    const char *why;
+
+    asm volatile("movl %%cr2, %0" : "=r"(addr));
+
+    read_lock(&vm_lock);
+    why = page_fault_resolve(r, addr);
+    read_unlock(&vm_lock);
+
+    /* Never with vm_lock held: killing a program does not return here */
+    if (why)
+        page_fault_fatal(r, addr, why);
+
+    elapsed = (uint32_t)(rdtsc() - start);
+    flags = spin_lock_irqsave(&pf_stats_lock);
+    pf_stats.cycles += elapsed;
+    if (elapsed > pf_stats.max_cycles)
+        pf_stats.max_cycles = elapsed;
+    spin_unlock_irqrestore(&pf_stats_lock, flags);
+}
+
+void init_paging(uint32_t mem_top)
+{
+    uint32_t kernel_guard = (uint32_t)stack_bottom - STACK_GUARD_SIZE;
+    uint32_t irq_guard = (uint32_t)irq_stack - STACK_GUARD_SIZE;
+    uint32_t df_guard = (uint32_t)df_stack - STACK_GUARD_SIZE;
+    uint32_t cr0;
+
+    if (mem_top > PMM_MAX_MEMORY)
+        mem_top = PMM_MAX_MEMORY;
+
+    /* Identity map all managed memory so kernel pointers stay valid, except
+       the guard pages: a stack overflow faults there and ends in #DF */
+    for (uint32_t addr = 0; addr < mem_top; addr += PAGE_SIZE) {
+        if (addr == kernel_guard || addr == irq_guard || addr == df_guard)
+            continue;
+        map_page(addr, addr, PAGE_WRITE);
+    }
+    map_page(GDT_ALIAS, 0, PAGE_WRITE);
+
+    zero_page = pmm_alloc_frame();
+    zero_frame(zero_page);
+
+    register_interrupt_handler(14, page_fault_handler);
+
+    asm volatile("movl %0, %%cr3" : : "r"(page_directory));
+
+    /* The double fault task switch reloads CR3 from its TSS */
+    df_tss.cr3 = (uint32_t)page_directory;
+
+    /* PG | WP: enable paging and write-protect in ring 0 too */
+    asm volatile("movl %%cr0, %0" : "=r"(cr0));
+    cr0 |= 0x80010000;
+    asm volatile("movl %0, %%cr0" : : "r"(cr0));
+
+    /* Only the GDT lives in page 0: reach it through the alias and unmap
+       the NULL page so stray NULL dereferences fault */
+    gdt_relocate(GDT_ALIAS + ((uint32_t)gdt_entries & ~PAGE_MASK));
+    unmap_page(0);
+}
+
+/* 64-by-32 division without libgcc; saturates if the quotient overflows */
+static uint32_t div64_32(uint64_t n, uint32_t d)
+{
+    uint32_t hi = (uint32_t)(n >> 32);
+    uint32_t q, r;
+
+    if (hi >= d)
+        return 0xFFFFFFFF;
+    asm("divl %4" : "=a"(q), "=d"(r) : "a"((uint32_t)n), "d"(hi), "rm"(d));
+    return q;
+}
+
+static uint32_t pf_total(void)
+{
+    return pf_stats.zero_maps + pf_stats.anon_faults + pf_stats.zero_upgrades;
+}
+
+void vm_print_stats(void)
+{
+    uint32_t faults = pf_total();
+    uint32_t reserved = 0;
+    uint32_t resident = 0;
+
+    terminal_write("Page faults: ");
+    terminal_write_dec(faults);
+    terminal_write(" (zero page ");
+    terminal_write_dec(pf_stats.zero_maps);
+    terminal_write(", new frame ");
+    terminal_write_dec(pf_stats.anon_faults);
+    terminal_write(", zero->frame ");
+    terminal_write_dec(pf_stats.zero_upgrades);
+    terminal_write(")\nCycles per fault: avg ");
+    terminal_write_dec(faults ? div64_32(pf_stats.cycles, faults) : 0);
+    terminal_write(", max ");
+    terminal_write_dec(pf_stats.max_cycles);
+    terminal_write("\n");
+
+    read_lock(&vm_lock);
+    for (int i = 0; i < VM_MAX_REGIONS; i++) {
+        if (!regions[i].used)
+            continue;
+        reserved += regions[i].end - regions[i].start;
+        resident += regions[i].resident * PAGE_SIZE;
+    }
+    read_unlock(&vm_lock);
+    terminal_write("Anonymous memory: resident ");
+    terminal_write_dec(resident / 1024);
+    terminal_write(" KB of ");
+    terminal_write_dec(reserved / 1024);
+    terminal_write(" KB reserved\nFree frames: ");
+    terminal_write_dec(pmm_free_frames());
+    terminal_write("/");
+    terminal_write_dec(pmm_total_frames());
+    terminal_write("\n");
+}
+
+static void vm_stress_report(const char *phase, struct vm_region *reg,
+                             uint32_t faults_before, uint64_t cycles_before)
+{
+    uint32_t faults = pf_total() - faults_before;
+
+    terminal_write(phase);
+    terminal_write(": resident ");
+    terminal_write_dec(reg->resident * PAGE_SIZE / 1024);
+    terminal_write(" KB of ");
+    terminal_write_dec((reg->end - reg->start) / 1024);
+    terminal_write(" KB, ");
+    terminal_write_dec(faults);
+    terminal_write(" faults, ");
+    terminal_write_dec(faults ? div64_32(pf_stats.cycles - cycles_before, faults) : 0);
+    terminal_write(" cycles/fault\n");
+}
+
+#define STRESS_PAGES 1024
+
+void vm_stress(void)
+{
+    uint32_t free_before = pmm_free_frames();
+    uint32_t faults;
+    uint64_t cycles;
+    uint32_t bad = 0;
+    volatile uint8_t *buf = vm_reserve(STRESS_PAGES * PAGE_SIZE, PAGE_WRITE);
+    struct vm_region *reg;
+
+    if (!buf) {
+        terminal_write("pfstress: cannot reserve region\n");
+        return;
+    }
+    reg = vm_find_region((uint32_t)buf);
+
+    /* Sparse writes: one byte every 16 pages */
+    faults = pf_total();
+    cycles = pf_stats.cycles;
+    for (uint32_t i = 0; i < STRESS_PAGES; i += 16)
+        buf[i * PAGE_SIZE] = (uint8_t)i + 1;
+    vm_stress_report("write 1/16", reg, faults, cycles);
+
+    /* Sparse reads: untouched pages must read as zero without new frames */
+    faults = pf_total();
+    cycles = pf_stats.cycles;
+    for (uint32_t i = 0; i < STRESS_PAGES; i += 4) {
+        uint8_t expect = (i % 16 == 0) ? (uint8_t)i + 1 : 0;
+        if (buf[i * PAGE_SIZE + 123] != 0 || buf[i * PAGE_SIZE] != expect)
+            bad++;
+    }
+    vm_stress_report("read 1/4", reg, faults, cycles);
+
+    /* Writes to pages already backed by the zero page */
+    faults = pf_total();
+    cycles = pf_stats.cycles;
+    for (uint32_t i = 4; i < STRESS_PAGES; i += 64)
+        buf[i * PAGE_SIZE] = 0xAA;
+    vm_stress_report("write 1/64 on zero page", reg, faults, cycles);
+
+    for (uint32_t i = 4; i < STRESS_PAGES; i += 64) {
+        if (buf[i * PAGE_SIZE] != 0xAA || buf[i * PAGE_SIZE + 1] != 0)
+            bad++;
+    }
+
+    vm_release((void *)buf);
+
+    terminal_write("Data check: ");
+    terminal_write(bad ? "FAILED" : "ok");
+    terminal_write(", frames still in use after release: ");
+    terminal_write_dec(free_before - pmm_free_frames());
+    terminal_write(" (page tables are kept)\n");
+}
@@ -0,0 +1,99 @@
+#include "pmm.h"
+#include "lock.h"
+
+#define FRAME_COUNT (PMM_MAX_MEMORY / FRAME_SIZE)
+
+/* One bit per frame, set = in use */
+static uint32_t frame_bitmap[FRAME_COUNT / 32];
+static uint32_t first_frame;
+static uint32_t total_frames;
+static uint32_t free_frames;
+static uint32_t next_hint;
+
+/* Frames are allocated from the page fault handler as well */
+static struct spinlock pmm_lock = SPINLOCK_INIT("pmm");
+
+static void frame_set(uint32_t idx)
+{
+    frame_bitmap[idx / 32] |= 1u << (idx % 32);
+}
+
+static void frame_clear(uint32_t idx)
+{
+    frame_bitmap[idx / 32] &= ~(1u << (idx % 32));
+}
+
+void init_pmm(uint32_t mem_top)
+{
+    uint32_t first = ((uint32_t)_kernel_end + FRAME_SIZE - 1) / FRAME_SIZE;
+
+    if (mem_top > PMM_MAX_MEMORY)
+        mem_top = PMM_MAX_MEMORY;
+    total_frames = mem_top / FRAME_SIZE;
+
+    /* Low memory and the kernel image are never handed out */
+    for (uint32_t i = 0; i < FRAME_COUNT / 32; i++)
+        frame_bitmap[i] = 0xFFFFFFFF;
+    for (uint32_t i = first; i < total_frames; i++)
+        frame_clear(i);
+
+    free_frames = total_frames > first ? total_frames - first : 0;
+    first_frame = first;
+    next_hint = first;
+}
+
+uint32_t pmm_alloc_frame(void)
+{
+    uint32_t flags = spin_lock_irqsave(&pmm_lock);
+    uint32_t frame = 0;
+
+    for (uint32_t n = 0; n < total_frames; n++) {
+        uint32_t idx = next_hint + n;
+        if (idx >= total_frames)
+            idx -= total_frames;
+
+        /* Skip fully used words quickly */
+        if (frame_bitmap[idx / 32] == 0xFFFFFFFF) {
+            n += 31 - idx % 32;
+            continue;
+        }
+        if (!(frame_bitmap[idx / 32] & (1u << (idx % 32)))) {
+            frame_set(idx);
+            free_frames--;
+            next_hint = idx + 1;
+            frame = idx * FRAME_SIZE;
+            break;
+        }
+    }
+    spin_unlock_irqrestore(&pmm_lock, flags);
+    return frame;
+}
+
+void pmm_free_frame(uint32_t frame)
+{
+    uint32_t idx = frame / FRAME_SIZE;
+    uint32_t flags;
+
+    /* Kernel image frames may be mapped elsewhere but are never freed */
+    if (idx < first_frame || idx >= total_frames)
+        return;
+
+    flags = spin_lock_irqsave(&pmm_lock);
+    if (frame_bitmap[idx / 32] & (1u << (idx % 32))) {
+        frame_clear(idx);
+        free_frames++;
+        if (idx < next_hint)
+            next_hint = idx;
+    }
+    spin_unlock_irqrestore(&pmm_lock, flags);
+}
+
+uint32_t pmm_free_frames(void)
+{
+    return free_frames;
+}
+
+uint32_t pmm_total_frames(void)
+{
+    return total_frames;
+}
@@ -0,0 +1,186 @@
+#include "process.h"
+#include "elf.h"
+#include "paging.h"
+#include "cpu.h"
+#include "terminal.h"
+
+/* Program images linked in by programs.asm (page aligned) */
+extern const uint8_t prog_hello_start[], prog_hello_end[];
+extern const uint8_t prog_fault_start[], prog_fault_end[];
+
+static const struct program programs[] = {
+    { "hello", prog_hello_start, prog_hello_end },
+    { "fault", prog_fault_start, prog_fault_end },
+    { NULL, NULL, NULL }
+};
+
+static struct user_context user_ctx;
+static const struct program *current;
+
+/* Local strcmp, as in shell.c */
+static int strcmp(const char *s1, const char *s2) {
+    while (*s1 && (*s1 == *s2)) {
+        s1++;
+        s2++;
+    }
+    return *(const unsigned char *)s1 - *(const unsigned char *)s2;
+}
+
+/* Every page of [addr, addr + len) must belong to a user region */
+static int user_range_ok(uint32_t addr, uint32_t len)
+{
+    struct vm_region *r;
+
+    if (addr < USER_BASE || len > USER_END - addr)
+        return 0;
+    while (len) {
+        uint32_t chunk;
+
+        r = vm_find_region(addr);
+        if (!r || !(r->flags & PAGE_USER))
+            return 0;
+        chunk = r->end - addr < len ? r->end - addr : len;
+        addr += chunk;
+        len -= chunk;
+    }
+    return 1;
+}
+
+static uint32_t sys_write(uint32_t buf, uint32_t len)
+{
+    if (!user_range_ok(buf, len))
+        return (uint32_t)-1;
+    for (uint32_t i = 0; i < len; i++)
+        terminal_putchar(((const char *)buf)[i]);
+    return len;
+}
+
+static void syscall_handler(struct regs *r)
+{
+    if (!current) {
+        r->eax = (uint32_t)-1;
+        return;
+    }
+
+    switch (r->eax) {
+    case SYS_EXIT:
+        leave_user(&user_ctx, (int)r->ebx);
+    case SYS_WRITE:
+        r->eax = sys_write(r->ebx, r->ecx);
+        break;
+    default:
+        r->eax = (uint32_t)-1;
+        break;
+    }
+}
+
+void process_fault(struct regs *r, const char *what, const uint32_t *addr)
+{
+    if (!current)
+        return;
+
+    terminal_write("\n");
+    terminal_write(current->name);
+    terminal_write(": killed by ");
+    terminal_write(what);
+    if (addr) {
+        terminal_write(" (0x");
+        terminal_write_hex(*addr);
+        terminal_write(")");
+    }
+    terminal_write(" at EIP 0x");
+    terminal_write_hex(r->eip);
+    terminal_write("\n");
+    leave_user(&user_ctx, -1);
+}
+
+void list_programs(void)
+{
+    terminal_write("Programs:");
+    for (const struct program *p = programs; p->name; p++) {
+        terminal_write(" ");
+        terminal_write(p->name);
+    }
+    terminal_write("\n");
+}
+
+static uint32_t resident_bytes(uint32_t addr)
+{
+    struct vm_region *r = vm_find_region(addr);
+
+    return r ? r->resident * PAGE_SIZE : 0;
+}
+
+int run_program(const char *name)
+{
+    const struct program *p;
+    struct elf_load_info info;
+    uint32_t *sp;
+    uint32_t load_cycles;
+    uint32_t resident;
+    uint64_t start;
+    int code;
+
+    for (p = programs; p->name && strcmp(p->name, name) != 0; p++)
+        ;
+    if (!p->name) {
+        terminal_write("run: no such program\n");
+        return -1;
+    }
+
+    start = rdtsc();
+    if (elf_load(p->image, p->image_end - p->image, &info) < 0)
+        return -1;
+
+    /* Lazily backed: only the pages the program touches cost a frame */
+    if (!vm_reserve_at(USER_STACK_TOP - USER_STACK_SIZE, USER_STACK_SIZE,
+                       PAGE_USER | PAGE_WRITE)) {
+        elf_unload(&info);
+        terminal_write("run: cannot reserve user stack\n");
+        return -1;
+    }
+
+    /* argc = 0, empty argv and envp */
+    sp = (uint32_t *)(USER_STACK_TOP - 16);
+    sp[0] = 0;
+    sp[1] = 0;
+    sp[2] = 0;
+    load_cycles = (uint32_t)(rdtsc() - start);
+
+    current = p;
+    code = enter_user(info.entry, (uint32_t)sp, &user_ctx);
+    current = NULL;
+
+    resident = resident_bytes(USER_STACK_TOP - USER_STACK_SIZE);
+    for (int i = 0; i < info.region_count; i++)
+        resident += resident_bytes(info.regions[i]);
+
+    vm_release((void *)(USER_STACK_TOP - USER_STACK_SIZE));
+    elf_unload(&info);
+
+    terminal_write(p->name);
+    terminal_write(": exit code ");
+    if (code < 0) {
+        terminal_write("-");
+        terminal_write_dec(-code);
+    } else {
+        terminal_write_dec(code);
+    }
+    terminal_write("\n  load: ");
+    terminal_write_dec(load_cycles);
+    terminal_write(" cycles, ");
+    terminal_write_dec(info.shared / 1024);
+    terminal_write(" KB mapped in place, ");
+    terminal_write_dec(info.copied / 1024);
+    terminal_write(" KB copied\n  memory: ");
+    terminal_write_dec(resident / 1024);
+    terminal_write(" KB resident of ");
+    terminal_write_dec((info.reserved + USER_STACK_SIZE) / 1024);
+    terminal_write(" KB reserved\n");
+    return code;
+}
+
+void init_process(void)
+{
+    register_interrupt_handler(SYSCALL_VECTOR, syscall_handler);
+}
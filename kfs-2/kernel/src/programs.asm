@@ -0,0 +1,20 @@
+; User programs embedded in the kernel image. Each image starts on a page
+; boundary and is zero padded to a whole page, so elf_load() can map
+; read-only segments (including their last page) without copying.
+
+section .rodata align=4096
+
+global prog_hello_start
+global prog_hello_end
+global prog_fault_start
+global prog_fault_end
+
+prog_hello_start:
+    incbin "user/hello.elf"
+    align 4096, db 0
+prog_hello_end:
+
+prog_fault_start:
+    incbin "user/fault.elf"
+    align 4096, db 0
+prog_fault_end:
@@ -2,6 +2,11 @@
 #include "vga.h"
 #include "keyboard.h"
 #include "types.h"
+#include "stack.h"
+#include "paging.h"
+#include "process.h"
+#include "lock.h"
+#include "terminal.h"
 
 #define SHELL_BUFFER_SIZE 256
 
@@ -14,11 +19,6 @@ static const char scancode_to_ascii[] = {
     '*', 0, ' '
 };
 
-/* External terminal routines that are now public (see main.c modifications) */
-extern void terminal_putchar(char c);
-extern void terminal_write(const char* str);
-extern void terminal_initialize(void);
-
 /* A few very basic string helper functions */
 static int strcmp(const char *s1, const char *s2) {
     while (*s1 && (*s1 == *s2)) {
@@ -67,6 +67,11 @@ static char shell_getchar(void) {
  *  - echo:   Print back the text following the command.
  *  - clear:  Clear the screen.
  *  - ls:     List files (a hard-coded file list).
+ *  - stackstat: Show peak usage of every kernel stack.
+ *  - vmstat: Show page fault counters and resident memory.
+ *  - pfstress: Demand paging stress test on a sparse region.
+ *  - run:    Run an embedded user program in ring 3.
+ *  - lockstat: Show lock contention statistics (LOCK_DEBUG builds).
  *  - exit:   Exit the shell.
  */
 void shell_run(void) {
@@ -114,6 +119,11 @@ void shell_run(void) {
             terminal_write("  echo TEXT - Print TEXT\n");
             terminal_write("  clear     - Clear the screen\n");
             terminal_write("  ls        - List files (simulated)\n");
+            terminal_write("  stackstat - Show peak stack usage\n");
+            terminal_write("  vmstat    - Show page fault statistics\n");
+            terminal_write("  pfstress  - Sparse demand paging test\n");
+            terminal_write("  run PROG  - Run a user program (run: list)\n");
+            terminal_write("  lockstat  - Show lock contention statistics\n");
             terminal_write("  exit      - Exit the shell\n");
         } else if (strncmp(buffer, "echo ", 5) == 0) {
             terminal_write(buffer + 5);
@@ -129,6 +139,18 @@ void shell_run(void) {
             terminal_write("kernel/\n");
             terminal_write("tools/\n");
             terminal_write("README.md\n");
+        } else if (strcmp(buffer, "stackstat") == 0) {
+            stack_print_stats();
+        } else if (strcmp(buffer, "vmstat") == 0) {
+            vm_print_stats();
+        } else if (strcmp(buffer, "pfstress") == 0) {
+            vm_stress();
+        } else if (strcmp(buffer, "lockstat") == 0) {
+            lock_print_stats();
+        } else if (strcmp(buffer, "run") == 0) {
+            list_programs();
+        } else if (strncmp(buffer, "run ", 4) == 0) {
+            run_program(buffer + 4);
         } else if (strcmp(buffer, "exit") == 0) {
             terminal_write("Exiting shell...\n");
             break;
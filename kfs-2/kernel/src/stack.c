@@ -0,0 +1,104 @@
+#include "stack.h"
+#include "gdt.h"
+#include "terminal.h"
+
+static struct kstack stacks[MAX_STACKS];
+static size_t stack_count;
+
+void stack_paint(void *bottom, void *top)
+{
+    for (uint32_t *p = bottom; p < (uint32_t *)top; p++)
+        *p = STACK_PAINT;
+}
+
+int stack_register(const char *name, void *bottom, void *top)
+{
+    if (stack_count == MAX_STACKS)
+        return -1;
+
+    stacks[stack_count].name = name;
+    stacks[stack_count].bottom = (uint32_t)bottom;
+    stacks[stack_count].top = (uint32_t)top;
+    stack_count++;
+    return 0;
+}
+
+/* Stacks grow down: the first overwritten word from the bottom is the peak */
+size_t stack_high_water(const struct kstack *s)
+{
+    const uint32_t *p = (const uint32_t *)s->bottom;
+
+    while (p < (const uint32_t *)s->top && *p == STACK_PAINT)
+        p++;
+    return s->top - (uint32_t)p;
+}
+
+void stack_print_stats(void)
+{
+    for (size_t i = 0; i < stack_count; i++) {
+        const struct kstack *s = &stacks[i];
+        size_t size = s->top - s->bottom;
+        size_t peak = stack_high_water(s);
+
+        terminal_write(s->name);
+        terminal_write(": 0x");
+        terminal_write_hex(s->bottom);
+        terminal_write("-0x");
+        terminal_write_hex(s->top);
+        terminal_write(" peak ");
+        terminal_write_dec(peak);
+        terminal_write("/");
+        terminal_write_dec(size);
+        terminal_write(" bytes (");
+        terminal_write_dec(peak * 100 / size);
+        terminal_write("%)");
+        if (peak == size)
+            terminal_write(" OVERFLOW?");
+        terminal_write("\n");
+    }
+}
+
+void init_stacks(void)
+{
+    /* The boot stack was painted in boot.asm, before it was in use */
+    stack_paint(irq_stack, irq_stack + IRQ_STACK_SIZE);
+    stack_paint(df_stack, df_stack + DF_STACK_SIZE);
+
+    stack_register("kernel", stack_bottom, stack_top);
+    stack_register("irq", irq_stack, irq_stack + IRQ_STACK_SIZE);
+    stack_register("double-fault", df_stack, df_stack + DF_STACK_SIZE);
+}
+
+/*
+ * Reached through the task gate on vector 8. A push into the unmapped page
+ * below a stack raises #PF, which cannot be delivered on the same stack and
+ * escalates to #DF; the CPU then saves the faulting state in kernel_tss
+ * and switches here with a fresh stack.
+ */
+void double_fault_task(void)
+{
+    struct tss_entry *t = &kernel_tss;
+
+    terminal_break_lock();
+    terminal_write("\n*** DOUBLE FAULT at EIP 0x");
+    terminal_write_hex(t->eip);
+    terminal_write(" ESP 0x");
+    terminal_write_hex(t->esp);
+    terminal_write(" ***\n");
+
+    for (size_t i = 0; i < stack_count; i++) {
+        const struct kstack *s = &stacks[i];
+
+        /* A function prologue can drop ESP well into the guard page before
+           the first push faults, so accept anywhere in the guard */
+        if (t->esp >= s->bottom - STACK_GUARD_SIZE && t->esp < s->bottom + 64) {
+            terminal_write("Stack overflow: ");
+            terminal_write(s->name);
+            terminal_write(" stack exhausted\n");
+        }
+    }
+
+    while (1) {
+        asm volatile("cli; hlt");
+    }
+}
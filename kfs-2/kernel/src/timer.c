@@ -0,0 +1,33 @@
+#include "timer.h"
+#include "idt.h"
+#include "keyboard.h"
+
+#define PIT_CHANNEL0 0x40
+#define PIT_COMMAND  0x43
+
+static volatile uint32_t ticks;
+
+static void timer_callback(struct regs *r)
+{
+    (void)r;
+    ticks++;
+}
+
+uint32_t timer_ticks(void)
+{
+    return ticks;
+}
+
+void init_timer(uint32_t hz)
+{
+    uint32_t divisor = PIT_FREQUENCY / hz;
+
+    register_interrupt_handler(IRQ0, timer_callback);
+
+    /* Channel 0, lobyte/hibyte, mode 3 (square wave) */
+    outb(PIT_COMMAND, 0x36);
+    outb(PIT_CHANNEL0, divisor & 0xFF);
+    outb(PIT_CHANNEL0, (divisor >> 8) & 0xFF);
+
+    irq_unmask(0);
+}
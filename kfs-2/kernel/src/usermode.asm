@@ -0,0 +1,68 @@
+; Ring 3 entry and exit for run_program() (see process.h)
+
+KERNEL_DATA_SEL equ 0x10
+USER_CODE_SEL   equ 0x20 | 3
+USER_DATA_SEL   equ 0x28 | 3
+USER_STACK_SEL  equ 0x30 | 3
+TSS_ESP0        equ 4           ; Offset of esp0 in struct tss_entry
+EFLAGS_IF       equ 0x200
+
+extern kernel_tss
+global enter_user
+global leave_user
+
+section .text
+
+; int enter_user(uint32_t eip, uint32_t esp, struct user_context *ctx)
+; Saves the callee-saved registers and EFLAGS, records the kernel stack
+; pointer in ctx and in the TSS, then IRETs to ring 3. "Returns" when the
+; program ends through leave_user().
+enter_user:
+    push ebp
+    push ebx
+    push esi
+    push edi
+    pushf
+
+    mov eax, [esp + 24]         ; eip
+    mov ecx, [esp + 28]         ; user esp
+    mov edx, [esp + 32]         ; ctx
+    mov [edx], esp
+
+    ; Interrupts from ring 3 land on the kernel stack just below this frame
+    mov [kernel_tss + TSS_ESP0], esp
+
+    mov bx, USER_DATA_SEL
+    mov ds, bx
+    mov es, bx
+    mov fs, bx
+    mov gs, bx
+
+    push dword USER_STACK_SEL
+    push ecx
+    pushf
+    or dword [esp], EFLAGS_IF   ; Keep taking IRQs in user mode
+    push dword USER_CODE_SEL
+    push eax
+    iret
+
+; void leave_user(struct user_context *ctx, int code)
+; Called from the exit system call or a fatal fault: drops the trap frame
+; and returns code from enter_user().
+leave_user:
+    mov edx, [esp + 4]
+    mov eax, [esp + 8]
+
+    mov cx, KERNEL_DATA_SEL
+    mov ds, cx
+    mov es, cx
+    mov fs, cx
+    mov gs, cx
+
+    mov esp, [edx]
+    popf
+    pop edi
+    pop esi
+    pop ebx
+    pop ebp
+    ret
@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <time.h>
+
+#include "host.h"
+
+/* Each benchmark runs this many times; the fastest run is reported */
+#define REPEAT 5
+
+#define SHELL_LINES 2000
+
+static unsigned long long now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void report(const char *name, unsigned long long best_ns, unsigned long ops)
+{
+    unsigned long long per_op_ps = best_ns * 1000ull / ops;
+
+    printf("%-24s %8llu.%03llu ns/op  (%lu ops, %llu us)\n", name,
+           per_op_ps / 1000, per_op_ps % 1000, ops, best_ns / 1000);
+}
+
+/* Time fn(ops) REPEAT times and report the best run */
+static void bench(const char *name, void (*fn)(unsigned long), unsigned long ops)
+{
+    unsigned long long best = ~0ull;
+
+    for (int i = 0; i < REPEAT; i++) {
+        unsigned long long start = now_ns();
+        unsigned long long elapsed;
+
+        fn(ops);
+        elapsed = now_ns() - start;
+        if (elapsed < best)
+            best = elapsed;
+    }
+    report(name, best, ops);
+}
+
+static void bench_putchar(unsigned long ops)
+{
+    for (unsigned long i = 0; i < ops; i++)
+        terminal_putchar('a' + i % 26);
+}
+
+static void bench_write_line(unsigned long ops)
+{
+    static const char line[] =
+        "The quick brown fox jumps over the lazy dog, again and again and again.\n";
+
+    for (unsigned long i = 0; i < ops; i++)
+        terminal_write(line);
+}
+
+static void bench_write_hex(unsigned long ops)
+{
+    for (unsigned long i = 0; i < ops; i++)
+        terminal_write_hex(i * 2654435761u);
+}
+
+static void bench_write_dec(unsigned long ops)
+{
+    for (unsigned long i = 0; i < ops; i++)
+        terminal_write_dec(i * 2654435761u);
+}
+
+static void bench_initialize(unsigned long ops)
+{
+    for (unsigned long i = 0; i < ops; i++)
+        terminal_initialize();
+}
+
+static void bench_gdt_set_gate(unsigned long ops)
+{
+    for (unsigned long i = 0; i < ops; i++)
+        host_gdt_set_gate(i % 7, i, ~i, 0x92, 0xCF);
+}
+
+static void bench_strcmp(unsigned long ops)
+{
+    static const char *const words[] = { "help", "echo x", "stackstat", "exit" };
+    volatile int sink = 0;
+
+    for (unsigned long i = 0; i < ops; i++)
+        sink += host_shell_strcmp(words[i % 4], "stackstat");
+}
+
+/* Whole read-evaluate loop: poll keys, edit, echo and dispatch */
+static void bench_shell_line(unsigned long ops)
+{
+    host_port_reset();
+    for (unsigned long i = 0; i < ops; i++)
+        host_keys(i % 2 ? "echo hello\n" : "stackstat\n");
+    host_keys("exit\n");
+    host_run_shell();
+}
+
+int main(void)
+{
+    host_shim_init();
+    terminal_initialize();
+
+    printf("Host microbenchmarks (best of %d runs)\n\n", REPEAT);
+    bench("terminal_putchar", bench_putchar, 1000000);
+    bench("terminal_write (72 ch)", bench_write_line, 20000);
+    bench("terminal_write_hex", bench_write_hex, 200000);
+    bench("terminal_write_dec", bench_write_dec, 200000);
+    bench("terminal_initialize", bench_initialize, 2000);
+    bench("gdt_set_gate", bench_gdt_set_gate, 1000000);
+    bench("shell strcmp", bench_strcmp, 1000000);
+    bench("shell line (per line)", bench_shell_line, SHELL_LINES);
+    return 0;
+}
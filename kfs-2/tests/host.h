@@ -0,0 +1,93 @@
+#ifndef HOST_H
+#define HOST_H
+
+/*
+ * Interface between the hosted test/bench programs (built against libc)
+ * and the kernel modules compiled by wrap_*.c. Only plain C types cross
+ * this boundary, since the kernel's types.h clashes with libc's.
+ */
+
+#define HOST_VGA_WIDTH  80
+#define HOST_VGA_HEIGHT 25
+
+/* Same layout as struct gdt_entry */
+struct host_gdt_entry {
+    unsigned short limit_low;
+    unsigned short base_low;
+    unsigned char base_middle;
+    unsigned char access;
+    unsigned char granularity;
+    unsigned char base_high;
+} __attribute__((packed));
+
+/* One outb() as seen by the shim */
+struct host_port_write {
+    unsigned short port;
+    unsigned char val;
+};
+
+/* --- shim.c: fake hardware --- */
+
+/* Map the fake VGA buffer at 0xB8000 and reset the port script */
+void host_shim_init(void);
+
+/* Queue key presses for the shell; every character must have a scancode */
+void host_keys(const char *text);
+
+/* Drop queued keys and recorded port writes */
+void host_port_reset(void);
+
+/* Port writes since the last host_port_reset(), oldest first */
+const struct host_port_write *host_port_writes(unsigned *count);
+
+/* Call the handler registered for an interrupt vector, as if it fired */
+void host_raise_interrupt(int vector);
+
+/* Whether irq_unmask() has been called for a PIC line */
+int host_irq_unmasked(int irq);
+
+/* Run shell_run(): 0 if it returned (exit), 1 if the key script ran dry */
+int host_run_shell(void);
+
+/* Text of one VGA row with trailing blanks removed */
+void host_vga_row(int row, char *out);
+
+/* Raw VGA cell (character | color << 8) */
+unsigned short host_vga_cell(int col, int row);
+
+/* Last shell command stub reached (e.g. "run_program hello") and count */
+const char *host_last_command(void);
+unsigned host_command_count(void);
+
+/* --- wrap_main.c: terminal --- */
+
+void terminal_initialize(void);
+void terminal_putchar(char c);
+void terminal_write(const char *str);
+void terminal_write_hex(unsigned int num);
+void terminal_write_dec(unsigned int num);
+unsigned long host_terminal_row(void);
+unsigned long host_terminal_column(void);
+
+/* --- wrap_shell.c: line editor and parser --- */
+
+void shell_run(void);
+int host_shell_strcmp(const char *s1, const char *s2);
+int host_shell_strncmp(const char *s1, const char *s2, unsigned long n);
+int host_shell_scancode(char c);
+
+/* --- wrap_gdt.c: descriptor encoding --- */
+
+void host_gdt_set_gate(int num, unsigned long base, unsigned long limit,
+                       unsigned char access, unsigned char gran);
+const struct host_gdt_entry *host_gdt_entry(int num);
+unsigned long host_sizeof_gdt_entry(void);
+unsigned long host_sizeof_gdt_ptr(void);
+unsigned long host_sizeof_tss(void);
+
+/* --- wrap_timer.c: PIT --- */
+
+void init_timer(unsigned int hz);
+unsigned int timer_ticks(void);
+
+#endif /* HOST_H */
@@ -0,0 +1,223 @@
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "host.h"
+
+#define VGA_ADDRESS 0xB8000
+
+/* Older libc headers lack it; the kernel has supported it since 4.17 */
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE 0x100000
+#endif
+
+/* Status polls with nothing queued before the shell is considered stuck */
+#define IDLE_POLL_LIMIT 1000
+
+#define SCRIPT_SIZE (1 << 20)
+#define PORT_LOG_SIZE 256
+
+static unsigned char script[SCRIPT_SIZE];
+static size_t script_head;
+static size_t script_tail;
+static int script_gap;
+static unsigned idle_polls;
+
+static struct host_port_write port_log[PORT_LOG_SIZE];
+static unsigned port_log_count;
+
+/* Opaque here: handlers get the kernel's isr_t type, but no frame */
+struct regs;
+
+static void (*interrupt_handlers[256])(struct regs *r);
+static unsigned irq_unmasked;
+
+static int shell_active;
+static jmp_buf shell_stuck;
+
+static char last_command[320];
+static unsigned command_count;
+
+/* --- Scripted port I/O --- */
+
+/*
+ * Models the PS/2 controller as the shell polls it: the status port reports
+ * a byte while one is queued, and reads empty once right after each data
+ * read so the shell's "wait for release" loop ends.
+ */
+unsigned char host_inb(unsigned short port)
+{
+    if (port == 0x64) {
+        if (script_gap) {
+            script_gap = 0;
+            return 0;
+        }
+        if (script_head < script_tail) {
+            idle_polls = 0;
+            return 1;
+        }
+        if (shell_active && ++idle_polls > IDLE_POLL_LIMIT)
+            longjmp(shell_stuck, 1);
+        return 0;
+    }
+    if (port == 0x60 && script_head < script_tail) {
+        script_gap = 1;
+        return script[script_head++];
+    }
+    return 0;
+}
+
+void host_outb(unsigned short port, unsigned char val)
+{
+    if (port_log_count == PORT_LOG_SIZE) {
+        fprintf(stderr, "host_outb: more than %d port writes\n", PORT_LOG_SIZE);
+        exit(2);
+    }
+    port_log[port_log_count].port = port;
+    port_log[port_log_count].val = val;
+    port_log_count++;
+}
+
+const struct host_port_write *host_port_writes(unsigned *count)
+{
+    *count = port_log_count;
+    return port_log;
+}
+
+void host_keys(const char *text)
+{
+    for (; *text; text++) {
+        int sc = host_shell_scancode(*text);
+
+        if (sc < 0 || script_tail == SCRIPT_SIZE) {
+            fprintf(stderr, "host_keys: cannot type 0x%x\n", (unsigned char)*text);
+            exit(2);
+        }
+        script[script_tail++] = sc;
+    }
+}
+
+void host_port_reset(void)
+{
+    script_head = 0;
+    script_tail = 0;
+    script_gap = 0;
+    idle_polls = 0;
+    port_log_count = 0;
+    last_command[0] = '\0';
+    command_count = 0;
+}
+
+int host_run_shell(void)
+{
+    int stuck;
+
+    shell_active = 1;
+    stuck = setjmp(shell_stuck);
+    if (!stuck)
+        shell_run();
+    shell_active = 0;
+    return stuck;
+}
+
+/* --- Fake VGA text buffer --- */
+
+void host_shim_init(void)
+{
+    void *vga = mmap((void *)VGA_ADDRESS, 4096, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+    if (vga != (void *)VGA_ADDRESS) {
+        fprintf(stderr, "host_shim_init: cannot map the VGA buffer at 0x%x\n",
+                VGA_ADDRESS);
+        exit(2);
+    }
+    host_port_reset();
+}
+
+unsigned short host_vga_cell(int col, int row)
+{
+    return ((volatile unsigned short *)VGA_ADDRESS)[row * HOST_VGA_WIDTH + col];
+}
+
+void host_vga_row(int row, char *out)
+{
+    int len = 0;
+
+    for (int col = 0; col < HOST_VGA_WIDTH; col++) {
+        out[col] = host_vga_cell(col, row) & 0xFF;
+        if (out[col] != ' ')
+            len = col + 1;
+    }
+    out[len] = '\0';
+}
+
+/* --- Stubs for the rest of the kernel --- */
+
+static void record(const char *name, const char *arg)
+{
+    snprintf(last_command, sizeof(last_command), "%s%s%s",
+             name, arg ? " " : "", arg ? arg : "");
+    command_count++;
+}
+
+const char *host_last_command(void)
+{
+    return last_command;
+}
+
+unsigned host_command_count(void)
+{
+    return command_count;
+}
+
+/* Commands the shell dispatches to */
+void stack_print_stats(void) { record("stack_print_stats", NULL); }
+void vm_print_stats(void) { record("vm_print_stats", NULL); }
+void vm_stress(void) { record("vm_stress", NULL); }
+void lock_print_stats(void) { record("lock_print_stats", NULL); }
+void list_programs(void) { record("list_programs", NULL); }
+
+int run_program(const char *name)
+{
+    record("run_program", name);
+    return 0;
+}
+
+/* Interrupt plumbing used by init_timer() */
+void register_interrupt_handler(unsigned char n, void (*handler)(struct regs *r))
+{
+    interrupt_handlers[n] = handler;
+}
+
+void irq_unmask(unsigned char irq)
+{
+    irq_unmasked |= 1u << irq;
+}
+
+void host_raise_interrupt(int vector)
+{
+    if (interrupt_handlers[vector])
+        interrupt_handlers[vector](NULL);
+}
+
+int host_irq_unmasked(int irq)
+{
+    return (irq_unmasked >> irq) & 1;
+}
+
+/* Referenced by kernel_main() and init_gdt(), never called on the host */
+unsigned char stack_bottom[16];
+unsigned char stack_top[16];
+unsigned char irq_stack[16];
+unsigned char df_stack[16];
+
+void double_fault_task(void) {}
+void init_stacks(void) {}
+void init_idt(void) {}
+void init_pmm(unsigned int mem_top) { (void)mem_top; }
+void init_paging(unsigned int mem_top) { (void)mem_top; }
+void init_process(void) {}
+void init_keyboard(void) {}
@@ -0,0 +1,57 @@
+#ifndef HOST_SHIM_H
+#define HOST_SHIM_H
+
+/*
+ * Forced into every kernel translation unit of the host build
+ * (-include tests/shim.h). Defining the include guards of the hardware
+ * headers first turns the real cpu.h and keyboard.h into no-ops, so the
+ * kernel code below sees these host versions instead.
+ */
+#define CPU_H
+#define KEYBOARD_H
+
+#include "types.h"
+#include "vga.h"
+
+/* --- keyboard.h --- */
+
+#define KEYBOARD_DATA_PORT    0x60
+#define KEYBOARD_STATUS_PORT  0x64
+
+void init_keyboard(void);
+void keyboard_handler(void);
+
+/* Scripted port I/O (shim.c) */
+uint8_t host_inb(uint16_t port);
+void host_outb(uint16_t port, uint8_t val);
+
+static inline uint8_t inb(uint16_t port) {
+    return host_inb(port);
+}
+
+static inline void outb(uint16_t port, uint8_t val) {
+    host_outb(port, val);
+}
+
+/* --- cpu.h --- */
+
+static inline uint64_t rdtsc(void) {
+    uint32_t lo, hi;
+    asm volatile ("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+static inline void cpu_pause(void) {
+    asm volatile ("pause" ::: "memory");
+}
+
+/* cli/sti would fault in user mode; a host process has no IRQs anyway */
+static inline uint32_t irq_save(void) {
+    return 0;
+}
+
+static inline void irq_restore(uint32_t flags) {
+    (void)flags;
+}
+
+#endif /* HOST_SHIM_H */
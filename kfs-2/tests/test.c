@@ -0,0 +1,344 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "host.h"
+
+static int failures;
+static int checks;
+
+#define CHECK(cond) do {                                                \
+        checks++;                                                       \
+        if (!(cond)) {                                                  \
+            failures++;                                                 \
+            printf("    %s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+        }                                                               \
+    } while (0)
+
+#define CHECK_ROW(row, text) do {                                       \
+        char line_[HOST_VGA_WIDTH + 1];                                 \
+        host_vga_row((row), line_);                                     \
+        checks++;                                                       \
+        if (strcmp(line_, (text)) != 0) {                               \
+            failures++;                                                 \
+            printf("    %s:%d: row %d is \"%s\", expected \"%s\"\n",    \
+                   __FILE__, __LINE__, (row), line_, (text));           \
+        }                                                               \
+    } while (0)
+
+/* Fresh screen and empty key script before every test */
+static void setup(void)
+{
+    host_port_reset();
+    terminal_initialize();
+}
+
+/* --- Terminal --- */
+
+static void test_terminal_initialize(void)
+{
+    terminal_write("dirty");
+    terminal_initialize();
+
+    CHECK(host_terminal_row() == 0 && host_terminal_column() == 0);
+    for (int row = 0; row < HOST_VGA_HEIGHT; row++) {
+        for (int col = 0; col < HOST_VGA_WIDTH; col++)
+            CHECK(host_vga_cell(col, row) == 0x0F20);
+    }
+}
+
+static void test_terminal_write(void)
+{
+    terminal_write("hi");
+
+    CHECK(host_vga_cell(0, 0) == (0x0F00 | 'h'));
+    CHECK(host_vga_cell(1, 0) == (0x0F00 | 'i'));
+    CHECK(host_terminal_row() == 0 && host_terminal_column() == 2);
+}
+
+static void test_terminal_newline(void)
+{
+    terminal_write("ab\ncd");
+
+    CHECK_ROW(0, "ab");
+    CHECK_ROW(1, "cd");
+    CHECK(host_terminal_row() == 1 && host_terminal_column() == 2);
+}
+
+static void test_terminal_line_wrap(void)
+{
+    for (int i = 0; i < HOST_VGA_WIDTH; i++)
+        terminal_putchar('x');
+    terminal_putchar('y');
+
+    CHECK(host_vga_cell(HOST_VGA_WIDTH - 1, 0) == (0x0F00 | 'x'));
+    CHECK(host_vga_cell(0, 1) == (0x0F00 | 'y'));
+    CHECK(host_terminal_row() == 1 && host_terminal_column() == 1);
+}
+
+/* No scrolling: the cursor wraps back to the top row */
+static void test_terminal_screen_wrap(void)
+{
+    for (int i = 0; i < HOST_VGA_HEIGHT; i++)
+        terminal_putchar('\n');
+    CHECK(host_terminal_row() == 0 && host_terminal_column() == 0);
+
+    for (int i = 0; i < HOST_VGA_WIDTH * HOST_VGA_HEIGHT; i++)
+        terminal_putchar('z');
+    CHECK(host_terminal_row() == 0 && host_terminal_column() == 0);
+}
+
+static void test_terminal_numbers(void)
+{
+    terminal_write_hex(0xDEADBEEF);
+    terminal_putchar('\n');
+    terminal_write_hex(0);
+    terminal_putchar('\n');
+    terminal_write_dec(0);
+    terminal_putchar('\n');
+    terminal_write_dec(4294967295u);
+    terminal_putchar('\n');
+    terminal_write_dec(1000);
+
+    CHECK_ROW(0, "DEADBEEF");
+    CHECK_ROW(1, "00000000");
+    CHECK_ROW(2, "0");
+    CHECK_ROW(3, "4294967295");
+    CHECK_ROW(4, "1000");
+}
+
+/* --- Shell --- */
+
+static void test_shell_echo_and_exit(void)
+{
+    host_keys("echo hello world\nexit\n");
+
+    CHECK(host_run_shell() == 0);
+    CHECK_ROW(0, "shell> echo hello world");
+    CHECK_ROW(1, "hello world");
+    CHECK_ROW(2, "shell> exit");
+    CHECK_ROW(3, "Exiting shell...");
+}
+
+static void test_shell_unknown_and_empty(void)
+{
+    host_keys("\nfoo\nexit\n");
+
+    CHECK(host_run_shell() == 0);
+    CHECK_ROW(0, "shell>");
+    CHECK_ROW(1, "shell> foo");
+    CHECK_ROW(2, "Command not found");
+    CHECK(host_command_count() == 0);
+}
+
+static void test_shell_dispatch(void)
+{
+    static const struct {
+        const char *line;
+        const char *command;
+    } cases[] = {
+        { "stackstat\n", "stack_print_stats" },
+        { "vmstat\n", "vm_print_stats" },
+        { "pfstress\n", "vm_stress" },
+        { "lockstat\n", "lock_print_stats" },
+        { "run\n", "list_programs" },
+        { "run hello\n", "run_program hello" },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        setup();
+        host_keys(cases[i].line);
+        host_keys("exit\n");
+        CHECK(host_run_shell() == 0);
+        CHECK(host_command_count() == 1);
+        CHECK(strcmp(host_last_command(), cases[i].command) == 0);
+    }
+}
+
+/* Commands are matched exactly: a prefix or suffix is not a command */
+static void test_shell_no_partial_match(void)
+{
+    host_keys("stack\nstackstatx\nexi\nexit\n");
+
+    CHECK(host_run_shell() == 0);
+    CHECK(host_command_count() == 0);
+}
+
+/* SHELL_BUFFER_SIZE is 256: characters past 255 are neither stored nor echoed */
+static void test_shell_line_limit(void)
+{
+    char line[400];
+    char tail[23];
+
+    strcpy(line, "run ");
+    memset(line + 4, 'a', 300);
+    strcpy(line + 304, "\nexit\n");
+    memset(tail, 'a', 22);
+    tail[22] = '\0';
+
+    host_keys(line);
+    CHECK(host_run_shell() == 0);
+    CHECK(strncmp(host_last_command(), "run_program aaa", 15) == 0);
+    CHECK(strlen(host_last_command()) == strlen("run_program ") + 251);
+
+    /* "shell> " + 255 echoed characters end 22 columns into row 3 */
+    CHECK_ROW(3, tail);
+    CHECK_ROW(4, "shell> exit");
+}
+
+static void test_shell_script_exhausted(void)
+{
+    host_keys("echo never ends");
+
+    CHECK(host_run_shell() == 1);
+    CHECK_ROW(0, "shell> echo never ends");
+}
+
+static void test_shell_string_helpers(void)
+{
+    CHECK(host_shell_strcmp("abc", "abc") == 0);
+    CHECK(host_shell_strcmp("abc", "abd") < 0);
+    CHECK(host_shell_strcmp("abd", "abc") > 0);
+    CHECK(host_shell_strcmp("ab", "abc") < 0);
+    CHECK(host_shell_strcmp("", "") == 0);
+    CHECK(host_shell_strncmp("echo hi", "echo ", 5) == 0);
+    CHECK(host_shell_strncmp("ech", "echo ", 5) != 0);
+    CHECK(host_shell_strncmp("abc", "abd", 2) == 0);
+    CHECK(host_shell_strncmp("abc", "xyz", 0) == 0);
+}
+
+/* --- GDT --- */
+
+static int gdt_bytes_are(int num, const unsigned char expect[8])
+{
+    return memcmp(host_gdt_entry(num), expect, 8) == 0;
+}
+
+static void test_gdt_layout(void)
+{
+    CHECK(host_sizeof_gdt_entry() == 8);
+    CHECK(host_sizeof_gdt_ptr() == 6);
+    CHECK(host_sizeof_tss() == 104);
+}
+
+static void test_gdt_flat_segments(void)
+{
+    static const unsigned char kernel_code[8] = { 0xFF, 0xFF, 0, 0, 0, 0x9A, 0xCF, 0 };
+    static const unsigned char user_data[8] = { 0xFF, 0xFF, 0, 0, 0, 0xF2, 0xCF, 0 };
+    static const unsigned char null[8] = { 0 };
+
+    host_gdt_set_gate(1, 0, 0xFFFFFFFF, 0x9A, 0xCF);
+    CHECK(gdt_bytes_are(1, kernel_code));
+    host_gdt_set_gate(5, 0, 0xFFFFFFFF, 0xF2, 0xCF);
+    CHECK(gdt_bytes_are(5, user_data));
+    host_gdt_set_gate(0, 0, 0, 0, 0);
+    CHECK(gdt_bytes_are(0, null));
+}
+
+static void test_gdt_base_and_limit_split(void)
+{
+    const struct host_gdt_entry *e;
+
+    /* Only the top nibble of gran is taken; limit bits 16-19 fill the rest */
+    host_gdt_set_gate(2, 0x12345678, 0xABCDE, 0x92, 0x4F);
+    e = host_gdt_entry(2);
+    CHECK(e->base_low == 0x5678);
+    CHECK(e->base_middle == 0x34);
+    CHECK(e->base_high == 0x12);
+    CHECK(e->limit_low == 0xBCDE);
+    CHECK(e->granularity == 0x4A);
+    CHECK(e->access == 0x92);
+}
+
+static void test_gdt_tss_descriptor(void)
+{
+    const struct host_gdt_entry *e;
+
+    /* Byte granular, limit is sizeof(TSS) - 1 */
+    host_gdt_set_gate(7, 0x00105020, 104 - 1, 0x89, 0x00);
+    e = host_gdt_entry(7);
+    CHECK(e->base_low == 0x5020);
+    CHECK(e->base_middle == 0x10);
+    CHECK(e->base_high == 0x00);
+    CHECK(e->limit_low == 0x0067);
+    CHECK(e->granularity == 0x00);
+    CHECK(e->access == 0x89);
+}
+
+/* --- PIT --- */
+
+static void test_timer_programs_pit(void)
+{
+    const struct host_port_write *w;
+    unsigned count;
+    unsigned ticks;
+
+    /* 1193182 / 100 = 11931 = 0x2E9B, sent low byte first */
+    init_timer(100);
+    w = host_port_writes(&count);
+    CHECK(count == 3);
+    CHECK(w[0].port == 0x43 && w[0].val == 0x36);
+    CHECK(w[1].port == 0x40 && w[1].val == 0x9B);
+    CHECK(w[2].port == 0x40 && w[2].val == 0x2E);
+    CHECK(host_irq_unmasked(0));
+
+    ticks = timer_ticks();
+    host_raise_interrupt(32);
+    CHECK(timer_ticks() == ticks + 1);
+}
+
+static void test_port_reset_clears_writes(void)
+{
+    unsigned count;
+
+    init_timer(1000);
+    host_port_reset();
+    host_port_writes(&count);
+    CHECK(count == 0);
+}
+
+static const struct {
+    const char *name;
+    void (*fn)(void);
+} tests[] = {
+    { "terminal_initialize", test_terminal_initialize },
+    { "terminal_write", test_terminal_write },
+    { "terminal_newline", test_terminal_newline },
+    { "terminal_line_wrap", test_terminal_line_wrap },
+    { "terminal_screen_wrap", test_terminal_screen_wrap },
+    { "terminal_numbers", test_terminal_numbers },
+    { "shell_echo_and_exit", test_shell_echo_and_exit },
+    { "shell_unknown_and_empty", test_shell_unknown_and_empty },
+    { "shell_dispatch", test_shell_dispatch },
+    { "shell_no_partial_match", test_shell_no_partial_match },
+    { "shell_line_limit", test_shell_line_limit },
+    { "shell_script_exhausted", test_shell_script_exhausted },
+    { "shell_string_helpers", test_shell_string_helpers },
+    { "gdt_layout", test_gdt_layout },
+    { "gdt_flat_segments", test_gdt_flat_segments },
+    { "gdt_base_and_limit_split", test_gdt_base_and_limit_split },
+    { "gdt_tss_descriptor", test_gdt_tss_descriptor },
+    { "timer_programs_pit", test_timer_programs_pit },
+    { "port_reset_clears_writes", test_port_reset_clears_writes },
+};
+
+int main(void)
+{
+    int failed_tests = 0;
+    size_t count = sizeof(tests) / sizeof(tests[0]);
+
+    host_shim_init();
+
+    for (size_t i = 0; i < count; i++) {
+        int before = failures;
+
+        setup();
+        tests[i].fn();
+        printf("%s %s\n", failures == before ? "PASS" : "FAIL", tests[i].name);
+        if (failures != before)
+            failed_tests++;
+    }
+
+    printf("\n%d/%d tests passed (%d checks, %d failed)\n",
+           (int)count - failed_tests, (int)count, checks, failures);
+    return failed_tests ? 1 : 0;
+}
@@ -0,0 +1,28 @@
+/* Descriptor encoders from gdt.c (init_gdt itself needs ring 0) */
+#include "../kernel/src/gdt.c"
+
+void host_gdt_set_gate(int num, unsigned long base, unsigned long limit,
+                       uint8_t access, uint8_t gran)
+{
+    gdt_set_gate(num, base, limit, access, gran);
+}
+
+const struct gdt_entry *host_gdt_entry(int num)
+{
+    return &gdt_entries[num];
+}
+
+size_t host_sizeof_gdt_entry(void)
+{
+    return sizeof(struct gdt_entry);
+}
+
+size_t host_sizeof_gdt_ptr(void)
+{
+    return sizeof(struct gdt_ptr);
+}
+
+size_t host_sizeof_tss(void)
+{
+    return sizeof(struct tss_entry);
+}
@@ -0,0 +1,12 @@
+/* Terminal code from main.c, plus access to its private state */
+#include "../kernel/src/main.c"
+
+size_t host_terminal_row(void)
+{
+    return terminal_row;
+}
+
+size_t host_terminal_column(void)
+{
+    return terminal_column;
+}
@@ -0,0 +1,22 @@
+/* Line editor and command parser from shell.c, plus its string helpers */
+#include "../kernel/src/shell.c"
+
+int host_shell_strcmp(const char *s1, const char *s2)
+{
+    return strcmp(s1, s2);
+}
+
+int host_shell_strncmp(const char *s1, const char *s2, size_t n)
+{
+    return strncmp(s1, s2, n);
+}
+
+/* Scancode the shell decodes to c, -1 if it has none */
+int host_shell_scancode(char c)
+{
+    for (size_t i = 0; i < sizeof(scancode_to_ascii); i++) {
+        if (scancode_to_ascii[i] == c && c != 0)
+            return i;
+    }
+    return -1;
+}
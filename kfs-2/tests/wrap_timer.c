@@ -0,0 +1,2 @@
+/* PIT setup from timer.c; its port writes land in the shim's log */
+#include "../kernel/src/timer.c"
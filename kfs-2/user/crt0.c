@@ -0,0 +1,9 @@
+#include "user.h"
+
+int main(void);
+
+/* Program entry: the kernel leaves argc/argv/envp on the stack, unused so far */
+void _start(void)
+{
+    sys_exit(main());
+}
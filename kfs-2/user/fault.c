@@ -0,0 +1,12 @@
+#include "user.h"
+
+/* Writes to kernel memory: the kernel must kill us and keep running */
+int main(void)
+{
+    volatile unsigned short *vga = (volatile unsigned short *)0xB8000;
+
+    puts("Writing to the VGA buffer from ring 3...\n");
+    vga[0] = 0x4F21;
+    puts("still alive?!\n");
+    return 0;
+}
@@ -0,0 +1,18 @@
+#include "user.h"
+
+/* Large .bss: only the pages touched below should become resident */
+static volatile char scratch[64 * 1024];
+
+int main(void)
+{
+    int sum = 0;
+
+    puts("Hello from ring 3!\n");
+
+    for (size_t i = 0; i < sizeof(scratch); i += 16 * 1024)
+        scratch[i] = 1;
+    for (size_t i = 0; i < sizeof(scratch); i += 4 * 1024)
+        sum += scratch[i];
+
+    return sum == 4 ? 0 : 1;
+}
@@ -0,0 +1,32 @@
+#ifndef USER_H
+#define USER_H
+
+/* System call numbers (must match kernel/include/process.h) */
+#define SYS_EXIT  1
+#define SYS_WRITE 2
+
+typedef unsigned int size_t;
+
+static inline int sys_write(const char *buf, size_t len) {
+    int ret;
+    asm volatile ("int $0x80" : "=a"(ret) : "a"(SYS_WRITE), "b"(buf), "c"(len) : "memory");
+    return ret;
+}
+
+static inline void sys_exit(int code) {
+    asm volatile ("int $0x80" : : "a"(SYS_EXIT), "b"(code) : "memory");
+    __builtin_unreachable();
+}
+
+static inline size_t strlen(const char *str) {
+    size_t len = 0;
+    while (str[len])
+        len++;
+    return len;
+}
+
+static inline int puts(const char *str) {
+    return sys_write(str, strlen(str));
+}
+
+#endif /* USER_H */